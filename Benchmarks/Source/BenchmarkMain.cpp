@@ -0,0 +1,247 @@
+/*
+  ==============================================================================
+    BenchmarkMain.cpp
+    Benchmark entry point.
+
+    Times the hot paths on a synthetic source and prints one JSON document:
+
+      CycleSnapBenchmark [--segments=256] [--events=4] [--tracks=4]
+                         [--loops=1,16,256] [--runs=5] [--out=<file.json>]
+
+    --segments  grid segments (M) in the source pattern
+    --events    notes starting on every grid line (each lasts one segment),
+                spread round-robin over --tracks tracks
+    --loops     values of N, in pattern loops, for solve / generate / write
+    --runs      timed runs per case (min, median and mean are reported)
+  ==============================================================================
+*/
+#include <JuceHeader.h>
+#include "MidiTransformEngine.h"
+#include "ModelCache.h"
+#include "StreamingMidiWriter.h"
+#include <iostream>
+
+namespace
+{
+    struct Config {
+        int segments = 256;
+        int eventsPerLine = 4;
+        int tracks = 4;
+        int runs = 5;
+        std::vector<int> loops{ 1, 16, 256 };
+    };
+
+    struct ModeInfo { GeoTimeMath::Mode mode; const char* name; };
+
+    // Same names as the batch --mode option
+    const ModeInfo kModes[] = {
+        { GeoTimeMath::Mode::TargetTotalScale, "target" },
+        { GeoTimeMath::Mode::FixedBeatRatio,   "accel" },
+        { GeoTimeMath::Mode::MatchBeatEnd,     "final" },
+        { GeoTimeMath::Mode::FitToCurve,       "curve" },
+        { GeoTimeMath::Mode::FitEndAndRatio,   "endfit" },
+    };
+
+    const double kBeatRatio = 1.5, kTotalScale = 2.0, kBeatEnd = 2.0;
+
+    // Writes a source with exactly 'segments' segments: every event sits on one of the
+    // segments + 1 grid lines, with uneven segment lengths so the solver sees a real pattern
+    bool writeSyntheticSource(const juce::File& file, const Config& config)
+    {
+        file.deleteFile();
+        juce::FileOutputStream stream(file);
+        if (!stream.openedOk()) return false;
+
+        StreamingMidiWriter writer(stream);
+        if (!writer.writeHeader(config.tracks > 1 ? 1 : 0, config.tracks, 960)) return false;
+
+        std::vector<juce::int64> lines{ 0 };
+        for (int b = 0; b < config.segments; ++b)
+            lines.push_back(lines.back() + 120 + (b * 53 % 7) * 60);
+
+        for (int t = 0; t < config.tracks; ++t) {
+            if (!writer.beginTrack()) return false;
+            if (t == 0) writer.writeEvent(0, juce::MidiMessage::tempoMetaEvent(500000));
+
+            for (size_t line = 0; line < lines.size(); ++line) {
+                for (int j = t; j < config.eventsPerLine; j += config.tracks) {
+                    int channel = 1 + j % 16;
+                    auto noteAt = [&](size_t l) { return 36 + (int)((l * 7 + (size_t)j) % 60); };
+
+                    if (line > 0) writer.writeEvent(lines[line], juce::MidiMessage::noteOff(channel, noteAt(line - 1)));
+                    if (line + 1 < lines.size()) writer.writeEvent(lines[line], juce::MidiMessage::noteOn(channel, noteAt(line), (juce::uint8)100));
+                }
+            }
+
+            if (!writer.endTrack(lines.back())) return false;
+        }
+
+        stream.flush();
+        return stream.getStatus().wasOk();
+    }
+
+    class Benchmark
+    {
+    public:
+        Benchmark(juce::String caseName, int numRuns) : name(std::move(caseName)), runs(numRuns) {}
+
+        // 'setup' runs untimed before every timed call of 'body'
+        template <typename SetupFn, typename BodyFn>
+        juce::var run(SetupFn&& setup, BodyFn&& body)
+        {
+            std::vector<double> ms;
+            for (int r = 0; r < runs; ++r) {
+                setup();
+                auto t0 = juce::Time::getHighResolutionTicks();
+                body();
+                ms.push_back(juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - t0) * 1000.0);
+            }
+
+            std::sort(ms.begin(), ms.end());
+            double sum = 0.0;
+            for (auto v : ms) sum += v;
+
+            result->setProperty("name", name);
+            result->setProperty("runs", runs);
+            result->setProperty("minMs", ms.front());
+            result->setProperty("medianMs", ms[ms.size() / 2]);
+            result->setProperty("meanMs", sum / (double)ms.size());
+            return juce::var(result.get());
+        }
+
+        template <typename BodyFn>
+        juce::var run(BodyFn&& body) { return run([] {}, body); }
+
+        Benchmark& with(const juce::Identifier& key, const juce::var& value) { result->setProperty(key, value); return *this; }
+
+    private:
+        juce::String name;
+        int runs;
+        juce::DynamicObject::Ptr result{ new juce::DynamicObject() };
+    };
+
+    std::vector<int> parseList(const juce::String& text, std::vector<int> fallback)
+    {
+        if (text.isEmpty()) return fallback;
+
+        std::vector<int> values;
+        for (auto& token : juce::StringArray::fromTokens(text, ",", ""))
+            if (token.getIntValue() > 0) values.push_back(token.getIntValue());
+        return values.empty() ? fallback : values;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    juce::ArgumentList args(argc, argv);
+
+    Config config;
+    auto readInt = [&](const juce::String& option, int& value) {
+        auto text = args.getValueForOption(option);
+        if (text.isNotEmpty()) value = juce::jmax(1, text.getIntValue());
+        };
+
+    readInt("--segments", config.segments);
+    readInt("--events", config.eventsPerLine);
+    readInt("--tracks", config.tracks);
+    readInt("--runs", config.runs);
+    config.tracks = juce::jmin(config.tracks, 0xffff);
+    config.loops = parseList(args.getValueForOption("--loops"), config.loops);
+
+    auto workDir = juce::File::getSpecialLocation(juce::File::tempDirectory).getChildFile("CycleSnapBenchmark");
+    workDir.deleteRecursively();
+    if (!workDir.createDirectory()) {
+        std::cerr << "Cannot create " << workDir.getFullPathName() << "\n";
+        return 2;
+    }
+
+    auto sourceFile = workDir.getChildFile("source.mid");
+    auto outputFile = workDir.getChildFile("output.mid");
+    if (!writeSyntheticSource(sourceFile, config)) {
+        std::cerr << "Cannot write the synthetic source\n";
+        return 2;
+    }
+
+    juce::Array<juce::var> results;
+
+    // --- Model load: parse + analysis, then the same file from a warm model cache ---
+    MidiGridModel model;
+    results.add(Benchmark("load", config.runs).run([&] { model.load(sourceFile); }));
+
+    ModelCache cache(workDir.getChildFile("cache"));
+    model.load(sourceFile, &cache);
+    results.add(Benchmark("loadCached", config.runs).run([&] { model.load(sourceFile, &cache); }));
+
+    const auto& ctx = model.getSolverContext();
+
+    MidiTransformEngine engine;
+    if (engine.loadSource(sourceFile).failed()) {
+        std::cerr << "Cannot load the synthetic source\n";
+        return 1;
+    }
+
+    for (int loops : config.loops) {
+        // --- Solver: every mode, with the result cache cleared so each run really solves ---
+        for (const auto& m : kModes) {
+            GeoTimeMath::CalculationResult res;
+            results.add(Benchmark("solve", config.runs)
+                .with("mode", m.name).with("loops", loops)
+                .run([&] { ctx.clearCache(); },
+                     [&] { res = GeoTimeMath::solve(ctx, m.mode, loops, kBeatRatio, kTotalScale, kBeatEnd, true); }));
+        }
+
+        auto res = GeoTimeMath::solve(ctx, GeoTimeMath::Mode::TargetTotalScale, loops, kBeatRatio, kTotalScale, kBeatEnd, true);
+        if (!res.success) continue;
+
+        auto steps = res.repetitions;
+        auto events = engine.predictOutputEventCount(steps);
+
+        // --- Generation from scratch, and the patch path for a small change of s ---
+        results.add(Benchmark("generate", config.runs)
+            .with("loops", loops).with("steps", steps).with("outputEvents", events)
+            .run([&] { engine.discardOutput(); },
+                 [&] { engine.generateOutput(steps, res.stepScale); }));
+
+        results.add(Benchmark("regenerate", config.runs)
+            .with("loops", loops).with("steps", steps).with("outputEvents", events)
+            .run([&] { engine.generateOutput(steps, res.stepScale); },
+                 [&] { engine.generateOutput(steps, res.stepScale * 1.0001); }));
+
+        // --- SMF write (streams the whole output when it is above the in-memory threshold) ---
+        engine.generateOutput(steps, res.stepScale);
+        results.add(Benchmark("write", config.runs)
+            .with("loops", loops).with("steps", steps).with("outputEvents", events)
+            .with("streaming", engine.isStreamingExport())
+            .run([&] { engine.saveFile(outputFile); }));
+    }
+
+    juce::DynamicObject::Ptr configJson = new juce::DynamicObject();
+    configJson->setProperty("segments", config.segments);
+    configJson->setProperty("eventsPerLine", config.eventsPerLine);
+    configJson->setProperty("tracks", config.tracks);
+    configJson->setProperty("runs", config.runs);
+    configJson->setProperty("sourceEvents", model.getEvents().getNumEvents());
+
+    juce::DynamicObject::Ptr root = new juce::DynamicObject();
+    root->setProperty("juceVersion", juce::SystemStats::getJUCEVersion());
+    root->setProperty("cpus", juce::SystemStats::getNumCpus());
+    root->setProperty("config", juce::var(configJson.get()));
+    root->setProperty("results", results);
+
+    auto json = juce::JSON::toString(juce::var(root.get()));
+    auto outText = args.getValueForOption("--out");
+
+    if (outText.isNotEmpty()) {
+        auto outFile = juce::File::getCurrentWorkingDirectory().getChildFile(outText.unquoted());
+        if (!outFile.replaceWithText(json)) {
+            std::cerr << "Cannot write " << outFile.getFullPathName() << "\n";
+            return 2;
+        }
+    }
+    else {
+        std::cout << json << "\n";
+    }
+
+    workDir.deleteRecursively();
+    return 0;
+}
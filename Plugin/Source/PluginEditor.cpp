@@ -0,0 +1,145 @@
+/*
+  ==============================================================================
+    PluginEditor.cpp
+  ==============================================================================
+*/
+#include "PluginEditor.h"
+
+CycleSnapEditor::CycleSnapEditor(CycleSnapProcessor& owner)
+    : AudioProcessorEditor(owner), processor(owner)
+{
+    auto setupLabel = [&](juce::Label& l) {
+        addAndMakeVisible(l);
+        l.setFont(labelFont);
+        l.setColour(juce::Label::textColourId, cGreen.withAlpha(0.8f));
+        l.setJustificationType(juce::Justification::centredLeft);
+        };
+
+    auto setupSlider = [&](juce::Slider& s, juce::AudioParameterFloat& parameter) {
+        addAndMakeVisible(s);
+        s.setSliderStyle(juce::Slider::LinearBar);
+        s.setColour(juce::Slider::backgroundColourId, cBackground);
+        s.setColour(juce::Slider::trackColourId, cFrame);
+        s.setColour(juce::Slider::textBoxTextColourId, cCyan);
+        s.setColour(juce::Slider::textBoxOutlineColourId, cFrame);
+        sliderAttachments.push_back(std::make_unique<juce::SliderParameterAttachment>(parameter, s));
+        };
+
+    setupLabel(lblN);
+    setupSlider(sliderN, processor.getLoopsParameter());
+    setupLabel(lblS);
+    setupSlider(sliderS, processor.getBeatRatioParameter());
+    setupLabel(lblR);
+    setupSlider(sliderR, processor.getTotalScaleParameter());
+    setupLabel(lblSend);
+    setupSlider(sliderSend, processor.getBeatEndParameter());
+
+    setupLabel(lblMode);
+    addAndMakeVisible(modeSelector);
+    modeSelector.addItemList(processor.getModeParameter().choices, 1);
+    modeSelector.setColour(juce::ComboBox::backgroundColourId, cBackground);
+    modeSelector.setColour(juce::ComboBox::textColourId, cCyan);
+    modeSelector.setColour(juce::ComboBox::outlineColourId, cFrame);
+    modeSelector.setColour(juce::ComboBox::arrowColourId, cCyan);
+    modeAttachment = std::make_unique<juce::ComboBoxParameterAttachment>(processor.getModeParameter(), modeSelector);
+
+    addAndMakeVisible(chkIntLoops);
+    chkIntLoops.setColour(juce::ToggleButton::textColourId, cGreen);
+    chkIntLoops.setColour(juce::ToggleButton::tickColourId, cCyan);
+    intLoopsAttachment = std::make_unique<juce::ButtonParameterAttachment>(processor.getIntegerLoopsParameter(), chkIntLoops);
+
+    addAndMakeVisible(btnLoad);
+    btnLoad.setTooltip("Click or Drop MIDI file here.");
+    btnLoad.setColour(juce::TextButton::buttonColourId, cBackground);
+    btnLoad.setColour(juce::TextButton::textColourOffId, cCyan);
+    btnLoad.onClick = [this] {
+        auto fc = std::make_shared<juce::FileChooser>("Open MIDI", processor.getSourceFile(), "*.mid");
+        juce::Component::SafePointer<CycleSnapEditor> safeThis(this);
+
+        // The host may close the editor while the chooser is open
+        fc->launchAsync(juce::FileBrowserComponent::openMode | juce::FileBrowserComponent::canSelectFiles,
+            [safeThis, fc](const juce::FileChooser& c) {
+                if (safeThis != nullptr && c.getResult().exists()) safeThis->loadFile(c.getResult());
+            });
+        };
+
+    setupLabel(lblSource);
+    lblSource.setFont(dataFont);
+    lblSource.setColour(juce::Label::textColourId, cCyan);
+
+    setupLabel(lblStatus);
+
+    timerCallback();
+    startTimerHz(4);
+    setSize(460, 300);
+}
+
+CycleSnapEditor::~CycleSnapEditor()
+{
+    stopTimer();
+}
+
+void CycleSnapEditor::paint(juce::Graphics& g)
+{
+    g.fillAll(cBackground);
+
+    auto header = getLocalBounds().reduced(15).removeFromTop(30).toFloat();
+    g.setFont(headerFont);
+    g.setColour(juce::Colours::white);
+    g.drawText("CYCLESNAP LIVE", header, juce::Justification::topLeft, true);
+
+    g.setColour(cFrame);
+    g.fillRect(header.getRight() - 100, header.getY() + 10, 100.0f, 10.0f);
+}
+
+void CycleSnapEditor::resized()
+{
+    auto area = getLocalBounds().reduced(15);
+    area.removeFromTop(40);
+
+    auto source = area.removeFromTop(30);
+    btnLoad.setBounds(source.removeFromLeft(130));
+    source.removeFromLeft(10);
+    lblSource.setBounds(source);
+    area.removeFromTop(10);
+
+    auto row = [&](juce::Label& label, juce::Component& control) {
+        auto r = area.removeFromTop(26);
+        label.setBounds(r.removeFromLeft(150));
+        control.setBounds(r);
+        area.removeFromTop(6);
+        };
+
+    row(lblMode, modeSelector);
+    row(lblN, sliderN);
+    row(lblS, sliderS);
+    row(lblR, sliderR);
+    row(lblSend, sliderSend);
+
+    auto bottom = area.removeFromTop(24);
+    chkIntLoops.setBounds(bottom.removeFromLeft(150));
+    lblStatus.setBounds(bottom);
+}
+
+bool CycleSnapEditor::isInterestedInFileDrag(const juce::StringArray& files)
+{
+    return files.size() == 1 && files[0].endsWithIgnoreCase(".mid");
+}
+
+void CycleSnapEditor::filesDropped(const juce::StringArray& files, int, int)
+{
+    loadFile(juce::File(files[0]));
+}
+
+void CycleSnapEditor::loadFile(const juce::File& file)
+{
+    processor.loadSource(file);
+    timerCallback();
+}
+
+void CycleSnapEditor::timerCallback()
+{
+    auto file = processor.getSourceFile();
+    lblSource.setText(file == juce::File() ? juce::String("NO SOURCE") : file.getFileName(), juce::dontSendNotification);
+    lblStatus.setText(processor.getStatusText(), juce::dontSendNotification);
+}
@@ -0,0 +1,69 @@
+/*
+  ==============================================================================
+    PluginEditor.h
+
+    Source file picker, the solver parameters and the solver status. Controls
+    are bound to the processor's parameters through attachments; nothing here
+    talks to the audio thread.
+  ==============================================================================
+*/
+#pragma once
+
+#include <JuceHeader.h>
+#include "PluginProcessor.h"
+
+class CycleSnapEditor : public juce::AudioProcessorEditor,
+    public juce::FileDragAndDropTarget,
+    private juce::Timer
+{
+public:
+    explicit CycleSnapEditor(CycleSnapProcessor& owner);
+    ~CycleSnapEditor() override;
+
+    void paint(juce::Graphics&) override;
+    void resized() override;
+
+    // Drag & Drop
+    bool isInterestedInFileDrag(const juce::StringArray& files) override;
+    void filesDropped(const juce::StringArray& files, int x, int y) override;
+
+private:
+    void loadFile(const juce::File& file);
+    void timerCallback() override;
+
+    CycleSnapProcessor& processor;
+
+    juce::TextButton btnLoad{ "LOAD SOURCE" };
+    juce::Label lblSource{ "lblSource", "NO SOURCE" };
+    juce::Label lblStatus;
+
+    juce::Label lblMode{ "lblMode", "OPERATION MODE" };
+    juce::ComboBox modeSelector;
+    juce::ToggleButton chkIntLoops{ "INT LOOPS LOCK" };
+
+    juce::Label lblN{ "lblN", "REPETITIONS [N]" };
+    juce::Slider sliderN;
+    juce::Label lblS{ "lblS", "BEAT RATIO [s]" };
+    juce::Slider sliderS;
+    juce::Label lblR{ "lblR", "TOTAL SCALE [R]" };
+    juce::Slider sliderR;
+    juce::Label lblSend{ "lblSend", "BEAT END [E]" };
+    juce::Slider sliderSend;
+
+    // Created once the controls are set up (the combo box needs its items first)
+    std::unique_ptr<juce::ComboBoxParameterAttachment> modeAttachment;
+    std::unique_ptr<juce::ButtonParameterAttachment> intLoopsAttachment;
+    std::vector<std::unique_ptr<juce::SliderParameterAttachment>> sliderAttachments;
+
+    // Styles & Theme (as the app)
+    juce::Font headerFont{ "Courier New", 18.0f, juce::Font::bold };
+    juce::Font dataFont{ "Courier New", 14.0f, juce::Font::bold };
+    juce::Font labelFont{ "Courier New", 12.0f, juce::Font::plain };
+
+    const juce::Colour cBackground{ 0xff050505 };
+    const juce::Colour cFrame{ 0xff004411 };
+    const juce::Colour cCyan{ 0xff00ffff };
+    const juce::Colour cGreen{ 0xff00ff41 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(CycleSnapEditor)
+};
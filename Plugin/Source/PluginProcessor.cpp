@@ -0,0 +1,184 @@
+/*
+  ==============================================================================
+    PluginProcessor.cpp
+  ==============================================================================
+*/
+#include "PluginProcessor.h"
+#include "PluginEditor.h"
+
+// Polls for parameter changes and frees retired snapshots
+static constexpr int kSolveIntervalMs = 50;
+
+CycleSnapProcessor::CycleSnapProcessor()
+    : AudioProcessor(BusesProperties()) // A MIDI effect has no audio buses
+{
+    // Same ranges and defaults as the app's inputs
+    addParameter(mode = new juce::AudioParameterChoice({ "mode", 1 }, "Operation Mode",
+        { "Loop Target [Fix N, R]", "Loop Accel [Fix N, s]", "Loop Final [Fix N, E]",
+          "Curve Fit [Fix s, R]", "End Fit [Fix E, R]" }, 0));
+    addParameter(loops = new juce::AudioParameterFloat({ "loops", 1 }, "Repetitions [N]",
+        juce::NormalisableRange<float>(1.0f, 256.0f, 0.01f, 0.3f), 4.0f));
+    addParameter(beatRatio = new juce::AudioParameterFloat({ "beatRatio", 1 }, "Beat Ratio [s]",
+        juce::NormalisableRange<float>(0.05f, 8.0f, 0.0001f, 0.4f), 1.5f));
+    addParameter(totalScale = new juce::AudioParameterFloat({ "totalScale", 1 }, "Total Scale [R]",
+        juce::NormalisableRange<float>(0.05f, 16.0f, 0.0001f, 0.4f), 2.0f));
+    addParameter(beatEnd = new juce::AudioParameterFloat({ "beatEnd", 1 }, "Beat End [E]",
+        juce::NormalisableRange<float>(0.05f, 16.0f, 0.0001f, 0.4f), 2.0f));
+    addParameter(integerLoops = new juce::AudioParameterBool({ "integerLoops", 1 }, "Int Loops Lock", true));
+
+    for (auto* p : getParameters()) p->addListener(this);
+
+    startTimer(kSolveIntervalMs);
+}
+
+CycleSnapProcessor::~CycleSnapProcessor()
+{
+    stopTimer();
+    ++buildGeneration; // Queued builds skip their work
+    buildPool.removeAllJobs(true, 10000);
+    for (auto* p : getParameters()) p->removeListener(this);
+}
+
+void CycleSnapProcessor::prepareToPlay(double, int)
+{
+    sequencer.reset();
+}
+
+void CycleSnapProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midi)
+{
+    buffer.clear();
+
+    LiveSequencer::Position position;
+    if (auto* playHead = getPlayHead()) {
+        if (auto info = playHead->getPosition()) {
+            position.isPlaying = info->getIsPlaying();
+            position.ppq = info->getPpqPosition().orFallback(0.0);
+            position.bpm = info->getBpm().orFallback(120.0);
+        }
+    }
+
+    // Incoming notes are replaced, not merged: the warp is the whole output
+    midi.clear();
+    sequencer.render(midi, buffer.getNumSamples(), getSampleRate(), position);
+}
+
+juce::AudioProcessorEditor* CycleSnapProcessor::createEditor()
+{
+    return new CycleSnapEditor(*this);
+}
+
+juce::Result CycleSnapProcessor::loadSource(const juce::File& file)
+{
+    // A fresh model for every load: the playing snapshot keeps the old one alive until retired
+    auto newModel = std::make_shared<MidiGridModel>();
+    auto res = newModel->load(file, &modelCache);
+
+    if (res.failed()) {
+        statusText = "LOAD FAILED: " + res.getErrorMessage().toUpperCase();
+        return res;
+    }
+
+    model = std::move(newModel);
+    sourceFile = file;
+    statusText = "SOLVING...";
+    solveAndPublish();
+    return res;
+}
+
+void CycleSnapProcessor::timerCallback()
+{
+    if (needsSolve.exchange(false)) solveAndPublish();
+    publishFinishedBuild();
+    sequencer.collectGarbage();
+}
+
+void CycleSnapProcessor::solveAndPublish()
+{
+    needsSolve = false;
+    if (model == nullptr) return;
+
+    int generation = ++buildGeneration;
+    auto selectedMode = (GeoTimeMath::Mode)mode->getIndex();
+    double reps = loops->get(), s = beatRatio->get(), R = totalScale->get(), end = beatEnd->get();
+    bool intLoops = integerLoops->get();
+
+    // The model is immutable once loaded, and only this pool's single thread solves against
+    // its context, so the job needs no locking beyond the hand-over
+    buildPool.addJob([this, generation, source = model, selectedMode, reps, s, R, end, intLoops] {
+        if (generation != buildGeneration.load()) return; // Superseded while queued
+
+        auto build = std::make_unique<FinishedBuild>();
+        build->generation = generation;
+
+        auto res = GeoTimeMath::solve(source->getSolverContext(), selectedMode, reps, s, R, end, intLoops);
+
+        if (!res.success) {
+            build->status = "SOLVER: " + juce::String(res.message).toUpperCase();
+        }
+        else if (res.repetitions > kMaxLiveSteps) {
+            build->status = "N=" + juce::String(res.repetitions) + " IS TOO LONG FOR LIVE PLAYBACK";
+        }
+        else {
+            build->snapshot = LiveSequencer::createSnapshot(source, res.repetitions, res.stepScale);
+
+            int M = juce::jmax(1, (int)source->getDeltas().size());
+            build->status = "N=" + juce::String(res.repetitions) + " (" + juce::String((double)res.repetitions / M, 2)
+                + " LOOPS), DRIFT " + juce::String(res.errorMs, 2) + " MS";
+        }
+
+        if (generation != buildGeneration.load()) return; // Superseded while building
+
+        const juce::ScopedLock lock(finishedLock);
+        finishedBuild = std::move(build);
+        });
+}
+
+void CycleSnapProcessor::publishFinishedBuild()
+{
+    std::unique_ptr<FinishedBuild> build;
+    {
+        const juce::ScopedLock lock(finishedLock);
+        build = std::move(finishedBuild);
+    }
+
+    // A newer request is queued or building: this one is already stale
+    if (build == nullptr || build->generation != buildGeneration.load()) return;
+
+    if (build->snapshot != nullptr) sequencer.publish(std::move(build->snapshot));
+    statusText = build->status;
+}
+
+void CycleSnapProcessor::getStateInformation(juce::MemoryBlock& destData)
+{
+    juce::XmlElement state("CycleSnapState");
+    state.setAttribute("source", sourceFile.getFullPathName());
+    state.setAttribute("mode", mode->getIndex());
+    state.setAttribute("loops", (double)loops->get());
+    state.setAttribute("beatRatio", (double)beatRatio->get());
+    state.setAttribute("totalScale", (double)totalScale->get());
+    state.setAttribute("beatEnd", (double)beatEnd->get());
+    state.setAttribute("integerLoops", integerLoops->get() ? 1 : 0);
+    copyXmlToBinary(state, destData);
+}
+
+void CycleSnapProcessor::setStateInformation(const void* data, int sizeInBytes)
+{
+    auto state = getXmlFromBinary(data, sizeInBytes);
+    if (state == nullptr || !state->hasTagName("CycleSnapState")) return;
+
+    *mode = state->getIntAttribute("mode", mode->getIndex());
+    *loops = (float)state->getDoubleAttribute("loops", loops->get());
+    *beatRatio = (float)state->getDoubleAttribute("beatRatio", beatRatio->get());
+    *totalScale = (float)state->getDoubleAttribute("totalScale", totalScale->get());
+    *beatEnd = (float)state->getDoubleAttribute("beatEnd", beatEnd->get());
+    *integerLoops = state->getIntAttribute("integerLoops", integerLoops->get() ? 1 : 0) != 0;
+
+    auto path = state->getStringAttribute("source");
+    if (path.isNotEmpty()) loadSource(juce::File(path));
+}
+
+// Plugin entry point
+juce::AudioProcessor* JUCE_CALLTYPE createPluginFilter()
+{
+    return new CycleSnapProcessor();
+}
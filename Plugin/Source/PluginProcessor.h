@@ -0,0 +1,105 @@
+/*
+  ==============================================================================
+    PluginProcessor.h
+
+    CycleSnap as a MIDI effect: plays the geometric warp of the loaded source
+    in sync with the host transport. Parameters are read on the message thread;
+    the solve and the O(N) snapshot build run on a background thread, and the
+    message thread only hands the finished snapshot to the LiveSequencer. The
+    audio thread never sees the model being loaded or the solver running.
+  ==============================================================================
+*/
+#pragma once
+
+#include <JuceHeader.h>
+#include "LiveSequencer.h"
+
+class CycleSnapProcessor : public juce::AudioProcessor,
+    private juce::AudioProcessorParameter::Listener,
+    private juce::Timer
+{
+public:
+    CycleSnapProcessor();
+    ~CycleSnapProcessor() override;
+
+    void prepareToPlay(double sampleRate, int samplesPerBlock) override;
+    void releaseResources() override {}
+    void processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midi) override;
+    using AudioProcessor::processBlock;
+
+    juce::AudioProcessorEditor* createEditor() override;
+    bool hasEditor() const override { return true; }
+
+    const juce::String getName() const override { return JucePlugin_Name; }
+    bool acceptsMidi() const override { return true; }
+    bool producesMidi() const override { return true; }
+    bool isMidiEffect() const override { return true; }
+    double getTailLengthSeconds() const override { return 0.0; }
+
+    int getNumPrograms() override { return 1; }
+    int getCurrentProgram() override { return 0; }
+    void setCurrentProgram(int) override {}
+    const juce::String getProgramName(int) override { return {}; }
+    void changeProgramName(int, const juce::String&) override {}
+
+    void getStateInformation(juce::MemoryBlock& destData) override;
+    void setStateInformation(const void* data, int sizeInBytes) override;
+
+    // Message thread
+    juce::Result loadSource(const juce::File& file);
+    const juce::File& getSourceFile() const { return sourceFile; }
+    const juce::String& getStatusText() const { return statusText; }
+
+    juce::AudioParameterChoice& getModeParameter() { return *mode; }
+    juce::AudioParameterFloat& getLoopsParameter() { return *loops; }
+    juce::AudioParameterFloat& getBeatRatioParameter() { return *beatRatio; }
+    juce::AudioParameterFloat& getTotalScaleParameter() { return *totalScale; }
+    juce::AudioParameterFloat& getBeatEndParameter() { return *beatEnd; }
+    juce::AudioParameterBool& getIntegerLoopsParameter() { return *integerLoops; }
+
+    // The step-time table is built in O(N) (off the message thread) for every new solve
+    static constexpr int kMaxLiveSteps = 1 << 26;
+
+private:
+    // Automation can arrive on any thread: it only flags a re-solve for the timer
+    void parameterValueChanged(int, float) override { needsSolve = true; }
+    void parameterGestureChanged(int, bool) override {}
+
+    void timerCallback() override;
+
+    // Queues a solve + snapshot build of the current parameters. Builds run one at a time on
+    // buildPool; every request bumps buildGeneration, so queued or finished builds of older
+    // requests are dropped instead of published.
+    void solveAndPublish();
+    void publishFinishedBuild();
+
+    struct FinishedBuild {
+        int generation = 0;
+        std::unique_ptr<LiveSequencer::Snapshot> snapshot; // nullptr: nothing to play
+        juce::String status;
+    };
+
+    juce::AudioParameterChoice* mode;
+    juce::AudioParameterFloat* loops;
+    juce::AudioParameterFloat* beatRatio;
+    juce::AudioParameterFloat* totalScale;
+    juce::AudioParameterFloat* beatEnd;
+    juce::AudioParameterBool* integerLoops;
+
+    ModelCache modelCache{ ModelCache::getDefaultDirectory() };
+    std::shared_ptr<const MidiGridModel> model;
+    juce::File sourceFile;
+    juce::String statusText{ "NO SOURCE LOADED" };
+    std::atomic<bool> needsSolve{ false };
+
+    LiveSequencer sequencer;
+
+    std::atomic<int> buildGeneration{ 0 };
+    juce::CriticalSection finishedLock;
+    std::unique_ptr<FinishedBuild> finishedBuild; // Latest finished build, picked up by the timer
+
+    // Last, so it is destroyed (and its job finished) before everything the jobs use
+    juce::ThreadPool buildPool{ juce::ThreadPoolOptions{}.withThreadName("CycleSnap Build").withNumberOfThreads(1) };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(CycleSnapProcessor)
+};
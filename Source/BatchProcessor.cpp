@@ -0,0 +1,271 @@
+/*
+  ==============================================================================
+    BatchProcessor.cpp
+  ==============================================================================
+*/
+#include "BatchProcessor.h"
+#include "BoundedQueue.h"
+#include <iostream>
+#include <thread>
+
+bool BatchProcessor::parseMode(const juce::String& name, GeoTimeMath::Mode& mode)
+{
+    // Same five modes as the OPERATION MODE selector
+    if (name.isEmpty() || name == "target") { mode = GeoTimeMath::Mode::TargetTotalScale; return true; }
+    if (name == "accel")  { mode = GeoTimeMath::Mode::FixedBeatRatio; return true; }
+    if (name == "final")  { mode = GeoTimeMath::Mode::MatchBeatEnd; return true; }
+    if (name == "curve")  { mode = GeoTimeMath::Mode::FitToCurve; return true; }
+    if (name == "endfit") { mode = GeoTimeMath::Mode::FitEndAndRatio; return true; }
+    return false;
+}
+
+juce::Array<juce::File> BatchProcessor::collectInputs(const juce::String& pattern)
+{
+    juce::Array<juce::File> files;
+
+    auto path = juce::File::getCurrentWorkingDirectory().getChildFile(pattern.unquoted());
+
+    if (path.isDirectory()) {
+        for (auto& f : path.findChildFiles(juce::File::findFiles, false, "*.mid"))
+            files.add(f);
+    }
+    else if (path.getFileName().containsAnyOf("*?")) {
+        // Wildcard in the file name part only
+        for (auto& f : path.getParentDirectory().findChildFiles(juce::File::findFiles, false, path.getFileName()))
+            files.add(f);
+    }
+    else if (path.existsAsFile()) {
+        files.add(path);
+    }
+
+    // Stable output order regardless of the file system
+    std::sort(files.begin(), files.end(),
+        [](const juce::File& a, const juce::File& b) { return a.getFullPathName() < b.getFullPathName(); });
+    return files;
+}
+
+void BatchProcessor::loadStage(WorkItem& item, const Settings& settings)
+{
+    auto& r = *item.result;
+    item.engine = std::make_unique<MidiTransformEngine>();
+    item.engine->setModelCache(settings.cache);
+    item.engine->setStatsEnabled(settings.collectStats);
+    item.engine->setSolverThreads(settings.engineThreads);
+
+    auto t0 = juce::Time::getMillisecondCounterHiRes();
+    auto res = item.engine->loadSource(r.input);
+    r.loadMs = juce::Time::getMillisecondCounterHiRes() - t0;
+
+    if (res.failed()) r.message = res.getErrorMessage();
+}
+
+void BatchProcessor::computeStage(WorkItem& item, const Settings& settings)
+{
+    auto& r = *item.result;
+    if (r.message.isNotEmpty()) return;
+
+    auto t0 = juce::Time::getMillisecondCounterHiRes();
+    r.solve = item.engine->runSolver(settings.mode, settings.reps, settings.beatRatio,
+        settings.totalScale, settings.beatEnd, settings.integerLoops, settings.autoTuneTolerance);
+    auto t1 = juce::Time::getMillisecondCounterHiRes();
+    r.solveMs = t1 - t0;
+    if (!r.solve.success) {
+        r.message = r.solve.message.empty() ? juce::String("Solver failed.") : juce::String(r.solve.message);
+        return;
+    }
+
+    item.engine->setGenerationThreads(settings.engineThreads);
+    auto res = item.engine->generateOutput(r.solve.repetitions, r.solve.stepScale);
+    r.generateMs = juce::Time::getMillisecondCounterHiRes() - t1;
+    if (res.failed()) r.message = res.getErrorMessage();
+}
+
+void BatchProcessor::writeStage(WorkItem& item, const Settings& settings)
+{
+    auto& r = *item.result;
+
+    if (r.message.isEmpty()) {
+        auto dir = settings.outputDir != juce::File() ? settings.outputDir : r.input.getParentDirectory();
+
+        auto t0 = juce::Time::getMillisecondCounterHiRes();
+        auto res = item.engine->saveFile(dir.getChildFile(r.input.getFileNameWithoutExtension() + "_snap.mid"));
+        r.saveMs = juce::Time::getMillisecondCounterHiRes() - t0;
+
+        if (res.failed()) r.message = res.getErrorMessage();
+        else r.ok = true;
+    }
+
+    // Done with this file: release the source and generated sequence
+    r.stats = item.engine->getStats();
+    item.engine.reset();
+}
+
+void BatchProcessor::runPipeline(std::vector<FileResult>& results, const Settings& settings, int computeThreads)
+{
+    // Loading and writing are I/O bound, so they get their own small thread sets and overlap
+    // with the compute workers. Queue capacities cap how many parsed models and generated
+    // outputs can be held in memory at once.
+    const int ioThreads = 2;
+
+    BoundedQueue<int> pending(results.size());
+    BoundedQueue<WorkItem> loaded((size_t)computeThreads * 2);
+    BoundedQueue<WorkItem> generated((size_t)ioThreads);
+
+    for (int i = 0; i < (int)results.size(); ++i) pending.push(i);
+    pending.close();
+
+    std::atomic<int> loadersLeft{ ioThreads }, computersLeft{ computeThreads };
+    std::vector<std::thread> threads;
+
+    for (int t = 0; t < ioThreads; ++t) {
+        threads.emplace_back([&] {
+            int index = 0;
+            while (pending.pop(index)) {
+                WorkItem item;
+                item.result = &results[(size_t)index];
+                loadStage(item, settings);
+                loaded.push(std::move(item));
+            }
+            if (--loadersLeft == 0) loaded.close();
+            });
+    }
+
+    for (int t = 0; t < computeThreads; ++t) {
+        threads.emplace_back([&] {
+            WorkItem item;
+            while (loaded.pop(item)) {
+                computeStage(item, settings);
+                generated.push(std::move(item));
+            }
+            if (--computersLeft == 0) generated.close();
+            });
+    }
+
+    for (int t = 0; t < ioThreads; ++t) {
+        threads.emplace_back([&] {
+            WorkItem item;
+            while (generated.pop(item))
+                writeStage(item, settings);
+            });
+    }
+
+    for (auto& t : threads) t.join();
+}
+
+juce::String BatchProcessor::toCsvHeader(bool withStats)
+{
+    juce::String header = "file,status,repetitions,beatRatio,totalScale,beatEnd,errorMs,loadMs,solveMs,generateMs,saveMs,message";
+
+    if (withStats)
+        for (int i = 0; i < PerfStats::kNumStages; ++i) {
+            juce::String name(PerfStats::getStageName((PerfStats::Stage)i));
+            header << "," << name << "Ms," << name << "Count";
+        }
+    return header;
+}
+
+juce::String BatchProcessor::toCsvRow(const FileResult& r, bool withStats)
+{
+    auto quoted = [](const juce::String& s) { return "\"" + s.replace("\"", "\"\"") + "\""; };
+
+    juce::String row;
+    row << quoted(r.input.getFullPathName()) << ","
+        << (r.ok ? "ok" : "fail") << ","
+        << r.solve.repetitions << ","
+        << juce::String(r.solve.beatRatio, 6) << ","
+        << juce::String(r.solve.totalScale, 6) << ","
+        << juce::String(r.solve.beatEnd, 6) << ","
+        << juce::String(r.solve.errorMs, 3) << ","
+        << juce::String(r.loadMs, 2) << ","
+        << juce::String(r.solveMs, 2) << ","
+        << juce::String(r.generateMs, 2) << ","
+        << juce::String(r.saveMs, 2) << ","
+        << quoted(r.message);
+
+    if (withStats)
+        for (int i = 0; i < PerfStats::kNumStages; ++i) {
+            const auto& e = r.stats.get((PerfStats::Stage)i);
+            row << "," << juce::String(e.ms, 3) << "," << (juce::int64)e.count;
+        }
+    return row;
+}
+
+void BatchProcessor::printUsage()
+{
+    std::cerr << "Usage: CycleSnap --batch=<file|dir|glob> [--mode=target|accel|final|curve|endfit]\n"
+                 "                 [--n=4] [--s=1.5] [--r=2.0] [--e=2.0] [--no-int-loops]\n"
+                 "                 [--autotune=<tolerance %>] [--out=<dir>] [--threads=<count>]\n"
+                 "                 [--no-cache] [--stats]\n";
+}
+
+int BatchProcessor::run(const juce::ArgumentList& args)
+{
+    Settings settings;
+
+    if (!parseMode(args.getValueForOption("--mode"), settings.mode)) {
+        std::cerr << "Unknown mode: " << args.getValueForOption("--mode") << "\n";
+        printUsage();
+        return 2;
+    }
+
+    auto readDouble = [&](const juce::String& option, double& value) {
+        auto text = args.getValueForOption(option);
+        if (text.isNotEmpty()) value = text.getDoubleValue();
+        };
+
+    readDouble("--n", settings.reps);
+    readDouble("--s", settings.beatRatio);
+    readDouble("--r", settings.totalScale);
+    readDouble("--e", settings.beatEnd);
+    settings.integerLoops = !args.containsOption("--no-int-loops");
+    settings.collectStats = args.containsOption("--stats");
+    settings.autoTuneTolerance = juce::jmax(0.0, args.getValueForOption("--autotune").getDoubleValue() / 100.0);
+
+    ModelCache cache(ModelCache::getDefaultDirectory());
+    if (!args.containsOption("--no-cache")) settings.cache = &cache;
+
+    auto outText = args.getValueForOption("--out");
+    if (outText.isNotEmpty()) {
+        settings.outputDir = juce::File::getCurrentWorkingDirectory().getChildFile(outText.unquoted());
+        if (!settings.outputDir.createDirectory()) {
+            std::cerr << "Cannot create output directory: " << settings.outputDir.getFullPathName() << "\n";
+            return 2;
+        }
+    }
+
+    auto inputs = collectInputs(args.getValueForOption("--batch"));
+    if (inputs.isEmpty()) {
+        std::cerr << "No input files matched.\n";
+        printUsage();
+        return 2;
+    }
+
+    int numThreads = args.getValueForOption("--threads").getIntValue();
+    if (numThreads <= 0) numThreads = juce::SystemStats::getNumCpus();
+    numThreads = juce::jmin(numThreads, inputs.size());
+
+    // Cores the file-level threads leave idle go to each engine's generation and drift
+    // verification (few large files), so the workers never oversubscribe the machine
+    settings.engineThreads = juce::jmax(1, juce::SystemStats::getNumCpus() / numThreads);
+
+    std::vector<FileResult> results((size_t)inputs.size());
+    for (int i = 0; i < inputs.size(); ++i) results[(size_t)i].input = inputs[i];
+
+    auto batchStart = juce::Time::getMillisecondCounterHiRes();
+    runPipeline(results, settings, numThreads);
+
+    std::cout << toCsvHeader(settings.collectStats) << "\n";
+
+    int failures = 0;
+    for (auto& r : results) {
+        std::cout << toCsvRow(r, settings.collectStats) << "\n";
+        if (!r.ok) ++failures;
+    }
+    std::cout.flush();
+
+    std::cerr << results.size() << " files, " << failures << " failed, "
+              << juce::String(juce::Time::getMillisecondCounterHiRes() - batchStart, 1) << " ms on "
+              << numThreads << " compute threads\n";
+
+    return failures > 0 ? 1 : 0;
+}
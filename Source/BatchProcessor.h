@@ -0,0 +1,74 @@
+/*
+  ==============================================================================
+    BatchProcessor.h
+
+    Headless command-line mode.
+    Runs the files through an overlapped load -> compute -> write pipeline
+    (one engine per file, bounded queues between stages) and prints one CSV
+    row per file to stdout:
+
+      CycleSnap --batch=<file|dir|glob> [--mode=target|accel|final|curve|endfit]
+                [--n=4] [--s=1.5] [--r=2.0] [--e=2.0] [--no-int-loops]
+                [--autotune=<tolerance %>] [--out=<dir>] [--threads=<count>]
+                [--no-cache] [--stats]
+
+    Analysed sources are shared with the GUI through the model cache unless
+    --no-cache is given. --stats appends the engine's per-stage times and
+    counts (<stage>Ms, <stage>Count) to every row.
+    Returns 0 if every file succeeded, 1 if any failed, 2 on bad arguments.
+  ==============================================================================
+*/
+#pragma once
+#include <JuceHeader.h>
+#include "GeometricTimeSolver.h"
+#include "MidiTransformEngine.h"
+
+class BatchProcessor
+{
+public:
+    static bool isBatchCommandLine(const juce::ArgumentList& args) { return args.containsOption("--batch"); }
+
+    // Runs the whole batch synchronously and returns the process exit code
+    static int run(const juce::ArgumentList& args);
+
+private:
+    struct Settings {
+        GeoTimeMath::Mode mode = GeoTimeMath::Mode::TargetTotalScale;
+        double reps = 4.0, beatRatio = 1.5, totalScale = 2.0, beatEnd = 2.0;
+        bool integerLoops = true;
+        double autoTuneTolerance = 0.0; // Relative; 0 = plain solve
+        juce::File outputDir; // Empty = next to each input
+        const ModelCache* cache = nullptr;
+        int engineThreads = 1; // Per engine, for generation and drift verification; the files themselves already run in parallel
+        bool collectStats = false;
+    };
+
+    struct FileResult {
+        juce::File input;
+        bool ok = false;
+        juce::String message;
+        GeoTimeMath::CalculationResult solve;
+        double loadMs = 0.0, solveMs = 0.0, generateMs = 0.0, saveMs = 0.0;
+        PerfStats stats; // Engine stats, with --stats
+    };
+
+    static bool parseMode(const juce::String& name, GeoTimeMath::Mode& mode);
+    static juce::Array<juce::File> collectInputs(const juce::String& pattern);
+
+    // A file in flight between stages; 'result' points at its slot in the output table
+    struct WorkItem {
+        std::unique_ptr<MidiTransformEngine> engine;
+        FileResult* result = nullptr;
+    };
+
+    // Pipeline stages. Each one records its own timing and skips items that already failed.
+    static void loadStage(WorkItem& item, const Settings& settings);
+    static void computeStage(WorkItem& item, const Settings& settings);
+    static void writeStage(WorkItem& item, const Settings& settings);
+
+    static void runPipeline(std::vector<FileResult>& results, const Settings& settings, int computeThreads);
+
+    static juce::String toCsvHeader(bool withStats);
+    static juce::String toCsvRow(const FileResult& r, bool withStats);
+    static void printUsage();
+};
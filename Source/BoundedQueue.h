@@ -0,0 +1,63 @@
+/*
+  ==============================================================================
+    BoundedQueue.h
+
+    Fixed-capacity blocking FIFO connecting two pipeline stages.
+    push() blocks while the queue is full, so a fast producer can't run ahead
+    of its consumer and memory stays capped at 'capacity' items per queue.
+    Producers close() the queue when done; pop() then drains what is left and
+    returns false once it's empty.
+  ==============================================================================
+*/
+#pragma once
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+
+template <typename T>
+class BoundedQueue
+{
+public:
+    explicit BoundedQueue(size_t maxItems) : capacity(maxItems > 0 ? maxItems : 1) {}
+
+    // Returns false (dropping the item) if the queue was closed
+    bool push(T item)
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        notFull.wait(lock, [this] { return closed || items.size() < capacity; });
+        if (closed) return false;
+
+        items.push_back(std::move(item));
+        notEmpty.notify_one();
+        return true;
+    }
+
+    // Blocks until an item is available; returns false once closed and drained
+    bool pop(T& item)
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        notEmpty.wait(lock, [this] { return closed || !items.empty(); });
+        if (items.empty()) return false;
+
+        item = std::move(items.front());
+        items.pop_front();
+        notFull.notify_one();
+        return true;
+    }
+
+    void close()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        closed = true;
+        notFull.notify_all();
+        notEmpty.notify_all();
+    }
+
+private:
+    const size_t capacity;
+    std::deque<T> items;
+    bool closed = false;
+
+    std::mutex mutex;
+    std::condition_variable notFull, notEmpty;
+};
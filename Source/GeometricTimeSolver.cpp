@@ -4,54 +4,250 @@
   ==============================================================================
 */
 #include "GeometricTimeSolver.h"
+#include <functional>
+#include <thread>
+
+#if defined(__AVX2__)
+ #include <immintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+ #include <arm_neon.h>
+#endif
 
 namespace GeoTimeMath
 {
     // Solver constraints
     static const int kMaxBisectionIters = 100;
+    static const int kMaxNewtonIters = 50;
+    static const long long kRefineWindow = 16;
     static const double kEpsilon = 1e-7;
+    static const double kNewtonTolerance = 1e-12; // On ln(R), i.e. relative to target R
+    static const int kAutoTuneSamples = 41;       // Per swept input (1-D neighbourhoods)
+    static const int kAutoTuneSamples2D = 21;     // Per input when two inputs are swept
+    static const int kAutoTuneNeighbours = 2;     // Steps tried on each side of N (one loop with integer loops)
+
+    // Sum( x^l, l = 0..q-1 ) for x = e^log_x.
+    // Evaluated through expm1 so the series stays accurate when x is close to 1.0,
+    // and factored as e^((q-1)L) * ... for x > 1 so huge ratios overflow to inf instead of NaN.
+    static double geometric_series(double log_x, int q)
+    {
+        if (q <= 0) return 0.0;
 
-    // Helper: Calculates total duration given a specific per-step scale (s_step).
-    // Performs the summation: Sum( delta[i] * s_step^k )
-    static double compute_duration_with_step_s(const std::vector<double>& deltas, int n_steps, double s_step, double source_dur)
+        double qd = (double)q;
+        double ql = qd * log_x;
+
+        // Near-linear case: Taylor expansion around x = 1 (power sums of l)
+        if (std::abs(ql) < 1e-4) {
+            double s1 = qd * (qd - 1.0) / 2.0;
+            double s2 = s1 * (2.0 * qd - 1.0) / 3.0;
+            double s3 = s1 * s1;
+            return qd + log_x * (s1 + log_x * (s2 / 2.0 + log_x * s3 / 6.0));
+        }
+
+        if (log_x < 0.0)
+            return std::expm1(ql) / std::expm1(log_x);
+
+        return std::exp(ql - log_x) * (std::expm1(-ql) / std::expm1(-log_x));
+    }
+
+    // Sum( l * x^l, l = 0..q-1 ), i.e. d/dL of geometric_series(L, q).
+    // Same stability treatment: Taylor near x = 1, and the overflow-safe factoring for x > 1.
+    static double geometric_series_slope(double log_x, int q)
     {
-        if (deltas.empty() || source_dur <= kEpsilon) return 0.0;
+        if (q <= 1) return 0.0;
+
+        double qd = (double)q;
+        double ql = qd * log_x;
 
-        // Optimization: Linear case (s=1.0) is just a scalar multiple
-        if (std::abs(s_step - 1.0) < kEpsilon) {
-            return (double)n_steps / deltas.size();
+        if (std::abs(ql) < 1e-4) {
+            double s1 = qd * (qd - 1.0) / 2.0;
+            double s2 = s1 * (2.0 * qd - 1.0) / 3.0;
+            double s3 = s1 * s1;
+            return s1 + log_x * (s2 + log_x * s3 / 2.0);
         }
 
-        double total = 0.0;
-        size_t m_size = deltas.size();
+        if (log_x < 0.0) {
+            double g = std::expm1(ql) / std::expm1(log_x);
+            return (qd * std::exp(ql) - g * std::exp(log_x)) / std::expm1(log_x);
+        }
 
-        for (int k = 0; k < n_steps; ++k) {
-            total += deltas[k % m_size] * std::pow(s_step, k);
+        double g = std::expm1(-ql) / std::expm1(-log_x);
+        return std::exp(ql - log_x) * (qd - g) / -std::expm1(-log_x);
+    }
+
+    // Helper: Calculates total duration given a specific per-step scale (s_step).
+    // Closed form of Sum( delta[k % M] * s_step^k ): with N = q*M + r the sum splits into
+    // P(s) * Sum( s^(l*M) ) + s^(q*M) * P_r(s), where P is the weighted sum of one loop
+    // and P_r the weighted sum of its first r segments. Costs O(M) regardless of N.
+    static double compute_duration_with_step_s(const SolverContext& ctx, int n_steps, double s_step)
+    {
+        const auto& deltas = ctx.getDeltas();
+        double source_dur = ctx.getSourceDuration();
+        if (source_dur <= kEpsilon || n_steps <= 0) return 0.0;
+
+        // Uniform grid: delta * Sum( s_step^k, k < N )
+        if (ctx.isUniformGrid())
+            return deltas[0] * geometric_series(std::log(s_step), n_steps) / source_dur;
+
+        int m_size = (int)deltas.size();
+        int q = n_steps / m_size;
+        int r = n_steps % m_size;
+
+        // Linear case (s=1.0): plain prefix sums
+        if (s_step == 1.0) {
+            const auto& prefix = ctx.getPrefixSums();
+            return ((double)q * prefix[m_size] + prefix[r]) / source_dur;
         }
 
+        // Weighted loop sums, one pass
+        double loop_sum = 0.0;
+        double partial_sum = 0.0;
+        double w = 1.0;
+        for (int j = 0; j < m_size; ++j) {
+            if (j == r) partial_sum = loop_sum;
+            loop_sum += deltas[j] * w;
+            w *= s_step;
+        }
+
+        double log_loop = (double)m_size * std::log(s_step);
+
+        double total = loop_sum * geometric_series(log_loop, q);
+        if (r > 0) total += std::exp((double)q * log_loop) * partial_sum;
+
         return total / source_dur;
     }
 
+    struct DurationSample {
+        double value = 0.0; // R(s)
+        double slope = 0.0; // dR / d(ln s)
+    };
+
+    // Duration plus its analytic derivative in log space, from the same O(M) pass.
+    // d/du Sum( delta[k % M] * e^(k*u) ) = Sum( k * delta[k % M] * s^k ), which splits like the
+    // duration itself: M * P * Sum( l*x^l ) + Q * Sum( x^l ) + x^q * (q*M*P_r + Q_r),
+    // with Q the loop polynomial built from the derivative coefficients j * delta[j].
+    static DurationSample compute_duration_and_slope(const SolverContext& ctx, int n_steps, double s_step)
+    {
+        DurationSample out;
+        const auto& deltas = ctx.getDeltas();
+        const auto& coeffs = ctx.getDerivativeCoeffs();
+        double source_dur = ctx.getSourceDuration();
+        if (source_dur <= kEpsilon || n_steps <= 0) return out;
+
+        // Uniform grid: both sums are plain (weighted) geometric series
+        if (ctx.isUniformGrid()) {
+            double log_s = std::log(s_step);
+            out.value = deltas[0] * geometric_series(log_s, n_steps) / source_dur;
+            out.slope = deltas[0] * geometric_series_slope(log_s, n_steps) / source_dur;
+            return out;
+        }
+
+        int m_size = (int)deltas.size();
+        int q = n_steps / m_size;
+        int r = n_steps % m_size;
+
+        double loop_sum = 0.0, loop_slope = 0.0;
+        double partial_sum = 0.0, partial_slope = 0.0;
+        double w = 1.0;
+        for (int j = 0; j < m_size; ++j) {
+            if (j == r) { partial_sum = loop_sum; partial_slope = loop_slope; }
+            loop_sum += deltas[j] * w;
+            loop_slope += coeffs[j] * w;
+            w *= s_step;
+        }
+
+        double log_loop = (double)m_size * std::log(s_step);
+        double g = geometric_series(log_loop, q);
+        double h = geometric_series_slope(log_loop, q);
+
+        double total = loop_sum * g;
+        double slope = (double)m_size * loop_sum * h + loop_slope * g;
+        if (r > 0) {
+            double tail_scale = std::exp((double)q * log_loop);
+            total += tail_scale * partial_sum;
+            slope += tail_scale * ((double)q * m_size * partial_sum + partial_slope);
+        }
+
+        out.value = total / source_dur;
+        out.slope = slope / source_dur;
+        return out;
+    }
+
+    // Fixed-s evaluator: caches the prefix sums of P_r(s) once (O(M)) so that
+    // every duration query for a different N is O(1). Used by the N searches.
+    // Works in the context's scratch buffer, so it doesn't allocate.
+    class FixedStepDuration
+    {
+    public:
+        FixedStepDuration(const SolverContext& ctx, double s_step)
+            : prefix(ctx.getScratch()), sourceDur(ctx.getSourceDuration())
+        {
+            const auto& deltas = ctx.getDeltas();
+            prefix[0] = 0.0;
+            double w = 1.0;
+            for (size_t j = 0; j < deltas.size(); ++j) {
+                prefix[j + 1] = prefix[j] + deltas[j] * w;
+                w *= s_step;
+            }
+            logLoop = (double)deltas.size() * std::log(s_step);
+        }
+
+        double operator()(int n_steps) const
+        {
+            int m_size = (int)prefix.size() - 1;
+            if (m_size < 1 || sourceDur <= kEpsilon || n_steps <= 0) return 0.0;
+
+            int q = n_steps / m_size;
+            int r = n_steps % m_size;
+
+            double total = prefix[m_size] * geometric_series(logLoop, q);
+            if (r > 0) total += std::exp((double)q * logLoop) * prefix[r];
+            return total / sourceDur;
+        }
+
+        // R as N -> infinity: P(s) / (1 - s^M) for s < 1, unbounded otherwise
+        double limit() const
+        {
+            int m_size = (int)prefix.size() - 1;
+            if (m_size < 1 || sourceDur <= kEpsilon) return 0.0;
+            if (logLoop >= 0.0) return std::numeric_limits<double>::infinity();
+            return prefix[m_size] / -std::expm1(logLoop) / sourceDur;
+        }
+
+    private:
+        std::vector<double>& prefix;
+        double logLoop = 0.0;
+        double sourceDur = 0.0;
+    };
+
     // Binary search to find s_step that results in target_r
-    static double solve_s_step_bisection(const std::vector<double>& deltas, int n, double target_r, double source_dur)
+    static double solve_s_step_bisection(const SolverContext& ctx, int n, double target_r, int& iterations)
     {
         // If target R is linear, s must be 1.0
-        double linear_r = (double)n / deltas.size();
+        double linear_r = compute_duration_with_step_s(ctx, n, 1.0);
         if (std::abs(target_r - linear_r) < 0.001) return 1.0;
 
         double low = 0.00001;
         double high = 2.0;
 
         // Adaptive bounds: if target is huge/tiny, expand search space first
-        int safety = 0;
-        while (compute_duration_with_step_s(deltas, n, high, source_dur) < target_r && safety++ < 30) {
-            high *= 2.0;
+        {
+            PerfStats::ScopedTimer timer(ctx.getStats(), PerfStats::Stage::SolveBracket);
+            int safety = 0;
+            while (safety++ < 30) {
+                ++iterations;
+                timer.addCount(1);
+                if (compute_duration_with_step_s(ctx, n, high) >= target_r) break;
+                high *= 2.0;
+            }
         }
 
         // Standard bisection
+        PerfStats::ScopedTimer timer(ctx.getStats(), PerfStats::Stage::SolveIterate);
         for (int i = 0; i < kMaxBisectionIters; ++i) {
             double mid = low + (high - low) * 0.5;
-            double r_mid = compute_duration_with_step_s(deltas, n, mid, source_dur);
+            double r_mid = compute_duration_with_step_s(ctx, n, mid);
+            ++iterations;
+            timer.addCount(1);
 
             if (std::abs(r_mid - target_r) < kEpsilon) return mid;
 
@@ -61,34 +257,135 @@ namespace GeoTimeMath
         return low + (high - low) * 0.5;
     }
 
-    // Brute force N: supports stepping by 1 (any step) or M (full loops)
-    static int find_best_fit_n(const std::vector<double>& deltas, double s_step, double target_r, double source_dur, int step_stride)
+    // Safeguarded Newton search for s_step, done on g(u) = ln R(e^u) - ln target with u = ln(s).
+    // R(e^u) is a sum of exponentials with positive weights, so g is increasing, convex and close
+    // to linear away from s = 1: Newton converges from either side. Any step that leaves the
+    // bracket [low, high] (or hits an overflow) falls back to a bisection step.
+    // Returns false if it didn't converge.
+    static bool solve_s_step_newton(const SolverContext& ctx, int n, double target_r, double& s_out, int& iterations)
     {
-        // Sanity limit to prevent hang on bad inputs
-        int limit = std::max(1000, (int)deltas.size() * 100);
+        // Same search domain as the bisection solver
+        double low = std::log(0.00001);
+        double high = std::log(2.0) * 31.0;
 
-        double min_diff = std::numeric_limits<double>::max();
-        int best_n = step_stride;
+        double log_target = std::log(target_r);
+        double u = 0.0; // Start from the linear solution
+
+        PerfStats::ScopedTimer timer(ctx.getStats(), PerfStats::Stage::SolveIterate);
+        for (int i = 0; i < kMaxNewtonIters; ++i) {
+            auto sample = compute_duration_and_slope(ctx, n, std::exp(u));
+            ++iterations;
+            timer.addCount(1);
+
+            double g = std::log(sample.value) - log_target;
+            if (std::isfinite(g) && std::abs(g) <= kNewtonTolerance) { s_out = std::exp(u); return true; }
+
+            if (g < 0.0) low = u;
+            else high = u;
+
+            double next = u - g * sample.value / sample.slope;
+            if (!std::isfinite(next) || next <= low || next >= high)
+                next = low + (high - low) * 0.5;
+
+            if (std::abs(next - u) <= 1e-15 * (1.0 + std::abs(u))) {
+                s_out = std::exp(next);
+                return std::isfinite(g) && std::abs(g) <= kEpsilon;
+            }
+            u = next;
+        }
+        return false;
+    }
 
-        for (int k = step_stride; k <= limit; k += step_stride) {
-            double r = compute_duration_with_step_s(deltas, k, s_step, source_dur);
-            double diff = std::abs(r - target_r);
+    // Default TargetTotalScale solver: Newton, with bisection as the fallback
+    static double solve_s_step(const SolverContext& ctx, int n, double target_r, int& iterations)
+    {
+        // If target R is linear, s must be 1.0
+        double linear_r = compute_duration_with_step_s(ctx, n, 1.0);
+        if (std::abs(target_r - linear_r) < 0.001) return 1.0;
+
+        double s_step = 1.0;
+        if (solve_s_step_newton(ctx, n, target_r, s_step, iterations))
+            return s_step;
 
-            if (diff < min_diff) { min_diff = diff; best_n = k; }
+        return solve_s_step_bisection(ctx, n, target_r, iterations);
+    }
 
-            // Optimization: function is generally monotonic, stop if error grows
-            if (r > target_r && diff > min_diff) break;
+    // Bracketing search over the candidates N = first + i * stride (stride 1 = any step, M = full loops).
+    // Duration is increasing in N, so probe exponentially until the target is crossed and then
+    // binary search the crossing: O(log N) evaluations, bounded only by the int range of N.
+    // If the target is never reached within that range, returns the smallest N that gets
+    // within kEpsilon of what the largest N achieves.
+    template <typename DurationFn>
+    static int search_best_fit_n(int first, int stride, double target_r, PerfStats* stats, DurationFn&& durationAt)
+    {
+        const long long max_i = ((long long)std::numeric_limits<int>::max() - first) / stride;
+        auto n_at = [&](long long i) { return (int)(first + i * stride); };
+
+        long long evaluations = 0;
+        auto duration = [&](int n) { ++evaluations; return durationAt(n); };
+
+        // Smallest i in (lo, hi] with duration >= threshold, given duration(hi) >= threshold
+        auto first_reaching = [&](long long lo, long long hi, double threshold) {
+            while (hi - lo > 1) {
+                long long mid = lo + (hi - lo) / 2;
+                if (duration(n_at(mid)) < threshold) lo = mid;
+                else hi = mid;
+            }
+            return hi;
+        };
+
+        // 1. Exponential probing (lo = -1 means no candidate below the target yet)
+        long long lo = -1, hi = 0;
+        {
+            PerfStats::ScopedTimer timer(stats, PerfStats::Stage::SolveBracket);
+            while (duration(n_at(hi)) < target_r) {
+                if (hi == max_i) {
+                    double limit_r = duration(n_at(max_i));
+                    long long best = first_reaching(-1, max_i, limit_r - kEpsilon);
+                    timer.addCount(evaluations);
+                    return n_at(best);
+                }
+                lo = hi;
+                hi = std::min(max_i, hi * 2 + 1);
+            }
+            timer.addCount(evaluations);
         }
-        return best_n;
+        evaluations = 0;
+        PerfStats::ScopedTimer timer(stats, PerfStats::Stage::SolveIterate);
+
+        // 2. Binary search the crossing, then take the closest candidate in a small window around it
+        // (earlier wins a tie). The fixed-end curve is only near-monotonic for short uneven patterns,
+        // so the window catches a neighbouring crossing the bisection may have stepped over.
+        hi = first_reaching(lo, hi, target_r);
+
+        long long best_i = hi;
+        double min_diff = std::numeric_limits<double>::max();
+
+        for (long long i = std::max(0LL, hi - kRefineWindow); i <= std::min(max_i, hi + kRefineWindow); ++i) {
+            double diff = std::abs(duration(n_at(i)) - target_r);
+            if (diff < min_diff) { min_diff = diff; best_i = i; }
+        }
+        timer.addCount(evaluations);
+        return n_at(best_i);
+    }
+
+    // Finds N for a fixed s: supports stepping by 1 (any step) or M (full loops).
+    // Returns 0 if no N reaches target_r: for s < 1 the duration converges to the series limit,
+    // and a target at or beyond it would otherwise probe N up to the int range.
+    static int find_best_fit_n(const SolverContext& ctx, double s_step, double target_r, int step_stride)
+    {
+        FixedStepDuration duration(ctx, s_step);
+        if (target_r >= duration.limit()) return 0;
+        return search_best_fit_n(step_stride, step_stride, target_r, ctx.getStats(), duration);
     }
 
-    // Iteratively finds N when both End Scale and Total Ratio are locked.
-    // This is tricky because s changes as N changes.
-    static int find_best_fit_n_with_fixed_end(const std::vector<double>& deltas, double target_end, double target_r, double source_dur, int step_stride)
+    // Finds N when both End Scale and Total Ratio are locked.
+    // This is tricky because s changes as N changes: s_step = end ^ (1 / (N-1)).
+    static int find_best_fit_n_with_fixed_end(const SolverContext& ctx, double target_end, double target_r, int step_stride)
     {
         // Linear edge case
         if (std::abs(target_end - 1.0) < 0.001) {
-            int n = (int)std::round(target_r * deltas.size());
+            int n = (int)std::round(target_r * ctx.getSegmentCount());
 
             // Quantize to stride
             if (n % step_stride != 0) {
@@ -98,51 +395,102 @@ namespace GeoTimeMath
             return n;
         }
 
-        int limit = std::max(1000, (int)deltas.size() * 100);
-        double min_diff = std::numeric_limits<double>::max();
-
         // Start search at valid stride (need >1 point for a curve)
         int start = step_stride;
         if (start < 2) start = 2;
 
-        int best_n = start;
-
-        for (int k = start; k <= limit; k += step_stride) {
-            // 1. Derive s_step for this specific candidate N
-            // s_step = end ^ (1 / (N-1))
+        return search_best_fit_n(start, step_stride, target_r, ctx.getStats(), [&](int k) {
             double s_step = std::pow(target_end, 1.0 / (double)(k - 1));
+            return compute_duration_with_step_s(ctx, k, s_step);
+            });
+    }
 
-            // 2. Calculate resulting R
-            double r = compute_duration_with_step_s(deltas, k, s_step, source_dur);
-            double diff = std::abs(r - target_r);
+    // --- SolverContext ---
 
-            if (diff < min_diff) {
-                min_diff = diff;
-                best_n = k;
-            }
+    void SolverContext::build(const std::vector<double>& segmentDeltas, double sourceDur, const TempoMap& tempoMap)
+    {
+        deltas = segmentDeltas;
+        sourceDuration = sourceDur;
+
+        // Handle empty model edge case
+        if (deltas.empty()) {
+            deltas = { 960.0 };
+            sourceDuration = 960.0;
+        }
 
-            if (r > target_r && diff > min_diff) break;
+        prefixSums.assign(deltas.size() + 1, 0.0);
+        derivativeCoeffs.resize(deltas.size());
+        for (size_t i = 0; i < deltas.size(); ++i) {
+            prefixSums[i + 1] = prefixSums[i] + deltas[i];
+            derivativeCoeffs[i] = (double)i * deltas[i];
         }
-        return best_n;
+
+        scratch.assign(deltas.size() + 1, 0.0);
+
+        uniformGrid = std::all_of(deltas.begin(), deltas.end(), [&](double d) { return d == deltas[0]; });
+
+        tempo = tempoMap;
+
+        clearCache();
     }
 
-    CalculationResult solve(Mode mode, double targetReps, double inputBeatRatio, double targetTotalScale, double inputBeatEnd,
-        const std::vector<double>& deltas, double sourceDur, double bpm, int ppq, bool constrainToIntegerReps)
+    SolverContext::CacheKey SolverContext::CacheKey::make(Mode mode, double reps, double beatRatio, double totalScale,
+        double beatEnd, bool integerReps)
     {
-        CalculationResult res;
-
-        // --- Prep Data ---
-        std::vector<double> work_deltas = deltas;
-        double work_dur = sourceDur;
+        // Inputs a mode ignores must not split its entries: the UI writes every field back
+        // (rounded) after a solve, and the next solve would otherwise miss
+        CacheKey key;
+        key.mode = mode;
+        key.integerReps = integerReps;
 
-        // Handle empty model edge case
-        if (work_deltas.empty()) {
-            work_deltas = { 960.0 };
-            work_dur = 960.0;
+        switch (mode) {
+        case Mode::TargetTotalScale: key.reps = reps; key.totalScale = totalScale; break;
+        case Mode::FixedBeatRatio:   key.reps = reps; key.beatRatio = beatRatio; break;
+        case Mode::MatchBeatEnd:     key.reps = reps; key.beatEnd = beatEnd; break;
+        case Mode::FitToCurve:       key.beatRatio = beatRatio; key.totalScale = totalScale; break;
+        case Mode::FitEndAndRatio:   key.beatEnd = beatEnd; key.totalScale = totalScale; break;
         }
+        return key;
+    }
+
+    const CalculationResult* SolverContext::findCached(const CacheKey& key) const
+    {
+        for (const auto& entry : cache)
+            if (entry.valid && entry.key == key) return &entry.result;
+        return nullptr;
+    }
+
+    void SolverContext::storeCached(const CacheKey& key, const CalculationResult& result) const
+    {
+        auto& entry = cache[nextCacheSlot];
+        entry.key = key;
+        entry.result = result;
+        entry.valid = true;
+        nextCacheSlot = (nextCacheSlot + 1) % kCacheSize;
+    }
+
+    void SolverContext::clearCache() const
+    {
+        for (auto& entry : cache) entry.valid = false;
+        nextCacheSlot = 0;
+    }
+
+    // --- Solver ---
+
+    CalculationResult solve(Mode mode, double targetReps, double inputBeatRatio, double targetTotalScale, double inputBeatEnd,
+        const std::vector<double>& deltas, double sourceDur, double bpm, int ppq, bool constrainToIntegerReps)
+    {
+        SolverContext context;
+        context.build(deltas, sourceDur, TempoMap(ppq, bpm));
+        return solve(context, mode, targetReps, inputBeatRatio, targetTotalScale, inputBeatEnd, constrainToIntegerReps);
+    }
 
-        int m_seg_count = (int)work_deltas.size();
-        if (m_seg_count < 1) m_seg_count = 1;
+    // Mode-specific part of the solve: fills N, s_step, s, R and E (no drift stats).
+    // Returns false with res.message set if the inputs are invalid.
+    static bool solve_parameters(const SolverContext& ctx, Mode mode, double targetReps, double inputBeatRatio,
+        double targetTotalScale, double inputBeatEnd, bool constrainToIntegerReps, CalculationResult& res)
+    {
+        int m_seg_count = ctx.getSegmentCount();
 
         // Determine step stride
         // If "Integer Loops Only", we step by M. Otherwise step by 1.
@@ -150,7 +498,7 @@ namespace GeoTimeMath
 
         // Basic validation
         if (targetReps <= 0 && mode != Mode::FitToCurve && mode != Mode::FitEndAndRatio) {
-            res.message = "Invalid Repetitions"; return res;
+            res.message = "Invalid Repetitions"; return false;
         }
 
         // --- Domain Conversion Helpers ---
@@ -161,7 +509,7 @@ namespace GeoTimeMath
         // --- Solver Logic ---
         switch (mode) {
         case Mode::TargetTotalScale:
-            if (targetTotalScale <= 0) { res.message = "Total Scale > 0 required"; return res; }
+            if (targetTotalScale <= 0) { res.message = "Total Scale > 0 required"; return false; }
 
             res.repetitions = (int)std::round(targetReps * m_seg_count);
             // Apply stride constraint if needed
@@ -171,13 +519,13 @@ namespace GeoTimeMath
             if (res.repetitions < 1) res.repetitions = 1;
 
             res.totalScale = targetTotalScale;
-            res.stepScale = solve_s_step_bisection(work_deltas, res.repetitions, targetTotalScale, work_dur);
+            res.stepScale = solve_s_step(ctx, res.repetitions, targetTotalScale, res.solverIterations);
             res.beatRatio = stepToLoop(res.stepScale);
             res.message = "Solved Beat Ratio";
             break;
 
         case Mode::FixedBeatRatio:
-            if (inputBeatRatio <= 0) { res.message = "Beat Ratio > 0 required"; return res; }
+            if (inputBeatRatio <= 0) { res.message = "Beat Ratio > 0 required"; return false; }
 
             res.repetitions = (int)std::round(targetReps * m_seg_count);
             if (constrainToIntegerReps) {
@@ -187,12 +535,12 @@ namespace GeoTimeMath
 
             res.beatRatio = inputBeatRatio;
             res.stepScale = loopToStep(inputBeatRatio);
-            res.totalScale = compute_duration_with_step_s(work_deltas, res.repetitions, res.stepScale, work_dur);
+            res.totalScale = compute_duration_with_step_s(ctx, res.repetitions, res.stepScale);
             res.message = "Calculated Total Scale";
             break;
 
         case Mode::MatchBeatEnd:
-            if (inputBeatEnd <= 0) { res.message = "Beat End > 0 required"; return res; }
+            if (inputBeatEnd <= 0) { res.message = "Beat End > 0 required"; return false; }
 
             res.repetitions = (int)std::round(targetReps * m_seg_count);
             if (constrainToIntegerReps) {
@@ -203,26 +551,27 @@ namespace GeoTimeMath
             res.stepScale = (res.repetitions > 1)
                 ? std::pow(inputBeatEnd, 1.0 / (double)(res.repetitions - 1)) : 1.0;
             res.beatRatio = stepToLoop(res.stepScale);
-            res.totalScale = compute_duration_with_step_s(work_deltas, res.repetitions, res.stepScale, work_dur);
+            res.totalScale = compute_duration_with_step_s(ctx, res.repetitions, res.stepScale);
             res.message = "Solved Ratio from End";
             break;
 
         case Mode::FitToCurve:
-            if (inputBeatRatio <= 0 || targetTotalScale <= 0) { res.message = "Invalid Input"; return res; }
+            if (inputBeatRatio <= 0 || targetTotalScale <= 0) { res.message = "Invalid Input"; return false; }
             res.beatRatio = inputBeatRatio;
             res.stepScale = loopToStep(inputBeatRatio);
             res.totalScale = targetTotalScale;
-            res.repetitions = find_best_fit_n(work_deltas, res.stepScale, targetTotalScale, work_dur, search_stride);
+            res.repetitions = find_best_fit_n(ctx, res.stepScale, targetTotalScale, search_stride);
+            if (res.repetitions < 1) { res.message = "Total Scale not reachable for this Beat Ratio"; return false; }
             res.message = "Solved Repetitions (Curve)";
             break;
 
         case Mode::FitEndAndRatio:
-            if (inputBeatEnd <= 0 || targetTotalScale <= 0) { res.message = "Invalid Input"; return res; }
+            if (inputBeatEnd <= 0 || targetTotalScale <= 0) { res.message = "Invalid Input"; return false; }
             res.beatEnd = inputBeatEnd;
             res.totalScale = targetTotalScale;
 
             // 1. Find best N with stride
-            res.repetitions = find_best_fit_n_with_fixed_end(work_deltas, inputBeatEnd, targetTotalScale, work_dur, search_stride);
+            res.repetitions = find_best_fit_n_with_fixed_end(ctx, inputBeatEnd, targetTotalScale, search_stride);
 
             // 2. Back-calculate s for that N
             if (res.repetitions > 1)
@@ -241,23 +590,414 @@ namespace GeoTimeMath
         }
 
         res.success = true;
+        return true;
+    }
 
-        // --- Verification ---
-        // Calculate the actual realized ticks to detect quantization drift
-        double quantized_ticks = 0.0;
-        for (int k = 0; k < res.repetitions; ++k) {
-            double exact_dt = work_deltas[k % m_seg_count] * std::pow(res.stepScale, k);
-            quantized_ticks += (double)std::llround(exact_dt);
-        }
-
+    // Fills realizedScale / errorTicks / errorMs from the quantized tick total
+    static void set_drift_stats(const SolverContext& ctx, double quantized_ticks, CalculationResult& res)
+    {
+        double work_dur = ctx.getSourceDuration();
         res.realizedScale = quantized_ticks / work_dur;
         double ideal_ticks = work_dur * res.totalScale;
         res.errorTicks = std::abs(quantized_ticks - ideal_ticks);
 
-        int safe_ppq = (ppq > 0) ? ppq : 960;
-        double ms_per_tick = 60000.0 / (bpm * safe_ppq);
-        res.errorMs = res.errorTicks * ms_per_tick;
+        // The output ends on source grid line N mod M (M after a whole number of loops), and its
+        // copied tempo events put it at the tempo the source has there
+        int m_seg_count = ctx.getSegmentCount();
+        int end_line = res.repetitions > 0 ? (res.repetitions - 1) % m_seg_count + 1 : 0;
+        res.errorMs = res.errorTicks * ctx.getTempoMap().getMsPerTickAt(ctx.getPrefixSums()[(size_t)end_line]);
+    }
+
+    // llround() for a non-negative tick value as plain double arithmetic (no libm call, so the
+    // lane loops vectorise): adding and removing 2^52 rounds to the nearest integer with
+    // ties to even, and exact ties are then pushed up to match llround's half-away-from-zero.
+    // Needs strict IEEE evaluation (no fast-math), like the rest of this file.
+    static inline double round_ticks(double x)
+    {
+        const double kTwo52 = 4503599627370496.0;
+        double t = (x + kTwo52) - kTwo52;
+        t += (x - t == 0.5) ? 1.0 : 0.0;
+        return x < kTwo52 ? t : x; // Already integral
+    }
+
+    // --- Verification ---
+    // Calculate the actual realized ticks to detect quantization drift.
+    // Rounding has no closed form, but the scale is re-anchored once per loop
+    // (exact s^(l*M)) and carried forward by multiplication inside it.
+    //
+    // Every rounded term is an integer and every partial sum stays far below 2^53, so the terms
+    // can be added in any grouping without changing the total: loops are verified kVerifyLanes
+    // at a time (one loop per SIMD lane, each running the scalar sequence of operations), and
+    // very long sequences are split into fixed blocks of loops across threads. The result is
+    // bit-identical to a plain sequential loop.
+    static const int kVerifyLanes = 4;
+    static const long long kVerifyBlockLoops = 4096;       // Loops per parallel work block
+    static const long long kParallelVerifySteps = 1 << 21; // Below this, threads cost more than they save
+
+    // Scalar reference for one loop (also handles the trailing partial loop)
+    static double loop_ticks_scalar(const double* deltas, int len, double w, double s_step)
+    {
+        double ticks = 0.0;
+        for (int j = 0; j < len; ++j) {
+            ticks += round_ticks(deltas[j] * w);
+            w *= s_step;
+        }
+        return ticks;
+    }
+
+    // Sum of rounded ticks over the full loops [first_loop, end_loop)
+    static double quantized_loop_ticks(const double* deltas, int m_size, double s_step, double log_loop,
+        long long first_loop, long long end_loop)
+    {
+        double total = 0.0;
+        long long l = first_loop;
+
+#if defined(__AVX2__)
+        const __m256d step = _mm256_set1_pd(s_step);
+        const __m256d half = _mm256_set1_pd(0.5);
+        const __m256d one = _mm256_set1_pd(1.0);
+
+        for (; l + kVerifyLanes <= end_loop; l += kVerifyLanes) {
+            __m256d w = _mm256_set_pd(std::exp((double)(l + 3) * log_loop), std::exp((double)(l + 2) * log_loop),
+                std::exp((double)(l + 1) * log_loop), std::exp((double)l * log_loop));
+            __m256d acc = _mm256_setzero_pd();
+
+            for (int j = 0; j < m_size; ++j) {
+                __m256d x = _mm256_mul_pd(_mm256_set1_pd(deltas[j]), w);
+                // Ties to even, then push exact ties up (half away from zero, as round_ticks)
+                __m256d t = _mm256_round_pd(x, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+                __m256d tie = _mm256_cmp_pd(_mm256_sub_pd(x, t), half, _CMP_EQ_OQ);
+                acc = _mm256_add_pd(acc, _mm256_add_pd(t, _mm256_and_pd(tie, one)));
+                w = _mm256_mul_pd(w, step);
+            }
+
+            alignas(32) double lanes[kVerifyLanes];
+            _mm256_store_pd(lanes, acc);
+            total += (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+        }
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+        const float64x2_t step = vdupq_n_f64(s_step);
+
+        for (; l + kVerifyLanes <= end_loop; l += kVerifyLanes) {
+            double anchors[kVerifyLanes] = { std::exp((double)l * log_loop), std::exp((double)(l + 1) * log_loop),
+                std::exp((double)(l + 2) * log_loop), std::exp((double)(l + 3) * log_loop) };
+            float64x2_t w0 = vld1q_f64(anchors), w1 = vld1q_f64(anchors + 2);
+            float64x2_t acc0 = vdupq_n_f64(0.0), acc1 = vdupq_n_f64(0.0);
+
+            for (int j = 0; j < m_size; ++j) {
+                float64x2_t d = vdupq_n_f64(deltas[j]);
+                // FRINTA rounds half away from zero, exactly like llround
+                acc0 = vaddq_f64(acc0, vrndaq_f64(vmulq_f64(d, w0)));
+                acc1 = vaddq_f64(acc1, vrndaq_f64(vmulq_f64(d, w1)));
+                w0 = vmulq_f64(w0, step);
+                w1 = vmulq_f64(w1, step);
+            }
+
+            total += vaddvq_f64(acc0) + vaddvq_f64(acc1);
+        }
+#else
+        for (; l + kVerifyLanes <= end_loop; l += kVerifyLanes) {
+            double w[kVerifyLanes], acc[kVerifyLanes];
+            for (int i = 0; i < kVerifyLanes; ++i) {
+                w[i] = std::exp((double)(l + i) * log_loop);
+                acc[i] = 0.0;
+            }
+
+            for (int j = 0; j < m_size; ++j) {
+                double d = deltas[j];
+                for (int i = 0; i < kVerifyLanes; ++i) {
+                    acc[i] += round_ticks(d * w[i]);
+                    w[i] *= s_step;
+                }
+            }
+
+            total += (acc[0] + acc[1]) + (acc[2] + acc[3]);
+        }
+#endif
+
+        // Loops left over after the last full batch of lanes
+        for (; l < end_loop; ++l)
+            total += loop_ticks_scalar(deltas, m_size, std::exp((double)l * log_loop), s_step);
+
+        return total;
+    }
+
+    static void verify_drift(const SolverContext& ctx, CalculationResult& res)
+    {
+        const double* deltas = ctx.getDeltas().data();
+        int m_seg_count = ctx.getSegmentCount();
+        int n_steps = res.repetitions;
+        if (n_steps <= 0) { set_drift_stats(ctx, 0.0, res); return; }
+
+        PerfStats::ScopedTimer timer(ctx.getStats(), PerfStats::Stage::SolveVerify);
+        timer.addCount(n_steps);
+
+        double log_loop = (double)m_seg_count * std::log(res.stepScale);
+        long long full_loops = n_steps / m_seg_count;
+        int tail = n_steps % m_seg_count;
+
+        double quantized_ticks = 0.0;
+        long long num_blocks = (full_loops + kVerifyBlockLoops - 1) / kVerifyBlockLoops;
+        int budget = ctx.getMaxThreads() > 0 ? ctx.getMaxThreads() : (int)std::thread::hardware_concurrency();
+        int num_threads = (int)std::min<long long>(num_blocks, (long long)budget);
+
+        if (n_steps >= kParallelVerifySteps && num_threads > 1) {
+            // Fixed blocks, handed out round-robin; each thread keeps its own exact partial sum
+            std::vector<double> partial((size_t)num_threads, 0.0);
+            std::vector<std::thread> workers;
+            workers.reserve((size_t)num_threads);
+
+            for (int t = 0; t < num_threads; ++t) {
+                workers.emplace_back([&, t] {
+                    for (long long b = t; b < num_blocks; b += num_threads) {
+                        long long first = b * kVerifyBlockLoops;
+                        long long last = std::min(full_loops, first + kVerifyBlockLoops);
+                        partial[(size_t)t] += quantized_loop_ticks(deltas, m_seg_count, res.stepScale, log_loop, first, last);
+                    }
+                    });
+            }
+
+            for (auto& w : workers) w.join();
+            for (double p : partial) quantized_ticks += p;
+        }
+        else {
+            quantized_ticks = quantized_loop_ticks(deltas, m_seg_count, res.stepScale, log_loop, 0, full_loops);
+        }
+
+        if (tail > 0)
+            quantized_ticks += loop_ticks_scalar(deltas, tail, std::exp((double)full_loops * log_loop), res.stepScale);
+
+        set_drift_stats(ctx, quantized_ticks, res);
+    }
+
+    // verify_drift for up to kSweepLanes results sharing the same N, stepped in lockstep.
+    // Lanes (one s value each) are taken kVerifyLanes at a time through the same SIMD rounding
+    // as quantized_loop_ticks; each lane still runs exactly the scalar sequence of operations
+    // (same re-anchoring, same accumulation order), so its stats are bit-identical to verify_drift.
+    static const int kSweepLanes = 64;
+    static_assert(kSweepLanes % kVerifyLanes == 0, "Sweep lanes must fill whole SIMD groups");
+
+    // Adds one loop of len rounded terms to ticks[0..kVerifyLanes), lane i starting at scale
+    // w[i] and stepping by step[i]. All three arrays are 32-byte aligned.
+    static inline void lane_group_ticks(const double* deltas, int len, const double* step, const double* w,
+        double* ticks)
+    {
+#if defined(__AVX2__)
+        const __m256d s = _mm256_load_pd(step);
+        const __m256d half = _mm256_set1_pd(0.5);
+        const __m256d one = _mm256_set1_pd(1.0);
+        __m256d scale = _mm256_load_pd(w);
+        __m256d acc = _mm256_load_pd(ticks);
+
+        for (int j = 0; j < len; ++j) {
+            __m256d x = _mm256_mul_pd(_mm256_set1_pd(deltas[j]), scale);
+            __m256d t = _mm256_round_pd(x, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+            __m256d tie = _mm256_cmp_pd(_mm256_sub_pd(x, t), half, _CMP_EQ_OQ);
+            acc = _mm256_add_pd(acc, _mm256_add_pd(t, _mm256_and_pd(tie, one)));
+            scale = _mm256_mul_pd(scale, s);
+        }
+
+        _mm256_store_pd(ticks, acc);
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+        const float64x2_t s0 = vld1q_f64(step), s1 = vld1q_f64(step + 2);
+        float64x2_t w0 = vld1q_f64(w), w1 = vld1q_f64(w + 2);
+        float64x2_t acc0 = vld1q_f64(ticks), acc1 = vld1q_f64(ticks + 2);
+
+        for (int j = 0; j < len; ++j) {
+            float64x2_t d = vdupq_n_f64(deltas[j]);
+            acc0 = vaddq_f64(acc0, vrndaq_f64(vmulq_f64(d, w0)));
+            acc1 = vaddq_f64(acc1, vrndaq_f64(vmulq_f64(d, w1)));
+            w0 = vmulq_f64(w0, s0);
+            w1 = vmulq_f64(w1, s1);
+        }
 
+        vst1q_f64(ticks, acc0);
+        vst1q_f64(ticks + 2, acc1);
+#else
+        double scale[kVerifyLanes];
+        for (int i = 0; i < kVerifyLanes; ++i) scale[i] = w[i];
+
+        for (int j = 0; j < len; ++j) {
+            double d = deltas[j];
+            for (int i = 0; i < kVerifyLanes; ++i) {
+                ticks[i] += round_ticks(d * scale[i]);
+                scale[i] *= step[i];
+            }
+        }
+#endif
+    }
+
+    static void verify_drift_lanes(const SolverContext& ctx, CalculationResult* const* lanes, int num_lanes)
+    {
+        const double* deltas = ctx.getDeltas().data();
+        int m_seg_count = ctx.getSegmentCount();
+        int n_steps = lanes[0]->repetitions;
+
+        PerfStats::ScopedTimer timer(ctx.getStats(), PerfStats::Stage::SolveVerify);
+        timer.addCount((int64_t)n_steps * num_lanes);
+
+        // Padding lanes up to a whole SIMD group run on s = 1 and are dropped
+        int num_padded = (num_lanes + kVerifyLanes - 1) / kVerifyLanes * kVerifyLanes;
+        alignas(32) double step[kSweepLanes], w[kSweepLanes], ticks[kSweepLanes];
+        double log_loop[kSweepLanes];
+        for (int l = 0; l < num_padded; ++l) {
+            step[l] = l < num_lanes ? lanes[l]->stepScale : 1.0;
+            log_loop[l] = (double)m_seg_count * std::log(step[l]);
+            ticks[l] = 0.0;
+        }
+
+        for (int k0 = 0; k0 < n_steps; k0 += m_seg_count) {
+            double loop_index = (double)(k0 / m_seg_count);
+            for (int l = 0; l < num_padded; ++l) w[l] = std::exp(loop_index * log_loop[l]);
+
+            int loop_len = std::min(m_seg_count, n_steps - k0);
+            for (int l = 0; l < num_padded; l += kVerifyLanes)
+                lane_group_ticks(deltas, loop_len, step + l, w + l, ticks + l);
+        }
+
+        for (int l = 0; l < num_lanes; ++l)
+            set_drift_stats(ctx, ticks[l], *lanes[l]);
+    }
+
+    CalculationResult solve(const SolverContext& ctx, Mode mode, double targetReps, double inputBeatRatio,
+        double targetTotalScale, double inputBeatEnd, bool constrainToIntegerReps)
+    {
+        auto key = SolverContext::CacheKey::make(mode, targetReps, inputBeatRatio, targetTotalScale, inputBeatEnd,
+            constrainToIntegerReps);
+        if (const auto* cached = ctx.findCached(key))
+            return *cached;
+
+        CalculationResult res;
+        if (!solve_parameters(ctx, mode, targetReps, inputBeatRatio, targetTotalScale, inputBeatEnd,
+                constrainToIntegerReps, res))
+            return res;
+
+        verify_drift(ctx, res);
+
+        ctx.storeCached(key, res);
         return res;
     }
-}
\ No newline at end of file
+
+    // --- Sweep ---
+
+    std::vector<CalculationResult> sweep(const SolverContext& ctx, const SweepSpec& spec)
+    {
+        std::vector<CalculationResult> results(spec.size());
+        if (results.empty()) return results;
+
+        // 1. Mode-specific parameters, candidate by candidate (the root finders branch per input)
+        std::vector<CalculationResult*> solved;
+        solved.reserve(results.size());
+
+        size_t index = 0;
+        for (int iN = 0; iN < spec.reps.count; ++iN)
+            for (int iS = 0; iS < spec.beatRatio.count; ++iS)
+                for (int iR = 0; iR < spec.totalScale.count; ++iR)
+                    for (int iE = 0; iE < spec.beatEnd.count; ++iE) {
+                        auto& res = results[index++];
+                        if (solve_parameters(ctx, spec.mode, spec.reps.valueAt(iN), spec.beatRatio.valueAt(iS),
+                                spec.totalScale.valueAt(iR), spec.beatEnd.valueAt(iE), spec.constrainToIntegerReps, res))
+                            solved.push_back(&res);
+                    }
+
+        // 2. Drift verification dominates (O(N) per candidate): group candidates with the same N
+        // and verify up to kSweepLanes s values at a time
+        std::stable_sort(solved.begin(), solved.end(),
+            [](const CalculationResult* a, const CalculationResult* b) { return a->repetitions < b->repetitions; });
+
+        for (size_t i = 0; i < solved.size();) {
+            int lanes = 1;
+            while (lanes < kSweepLanes && i + lanes < solved.size()
+                && solved[i + lanes]->repetitions == solved[i]->repetitions)
+                ++lanes;
+
+            verify_drift_lanes(ctx, &solved[i], lanes);
+            i += (size_t)lanes;
+        }
+
+        return results;
+    }
+
+    // --- Auto-Tune ---
+
+    CalculationResult autoTune(const SolverContext& ctx, Mode mode, double targetReps, double inputBeatRatio,
+        double targetTotalScale, double inputBeatEnd, bool constrainToIntegerReps, double tolerance)
+    {
+        CalculationResult best = solve(ctx, mode, targetReps, inputBeatRatio, targetTotalScale,
+            inputBeatEnd, constrainToIntegerReps);
+        if (!best.success || tolerance <= 0.0) return best;
+
+        auto band = [&](double centre, int count) {
+            return SweepRange{ centre * (1.0 - tolerance), centre * (1.0 + tolerance), count };
+            };
+        auto within = [&](double value, double target) {
+            return std::abs(value - target) <= tolerance * std::abs(target) + 1e-12;
+            };
+
+        // Neighbouring repetition counts, in the same units as targetReps (loops)
+        double repUnit = constrainToIntegerReps ? 1.0 : 1.0 / ctx.getSegmentCount();
+        int neighbours = constrainToIntegerReps ? 1 : kAutoTuneNeighbours;
+        double minReps = std::max(repUnit, targetReps - neighbours * repUnit);
+        double maxReps = targetReps + neighbours * repUnit;
+        SweepRange repsBand{ minReps, maxReps, (int)std::round((maxReps - minReps) / repUnit) + 1 };
+
+        SweepSpec spec;
+        spec.mode = mode;
+        spec.constrainToIntegerReps = constrainToIntegerReps;
+        spec.reps = { targetReps, targetReps, 1 };
+        spec.beatRatio = { inputBeatRatio, inputBeatRatio, 1 };
+        spec.totalScale = { targetTotalScale, targetTotalScale, 1 };
+        spec.beatEnd = { inputBeatEnd, inputBeatEnd, 1 };
+
+        // What may move, and what has to stay within tolerance
+        std::function<bool(const CalculationResult&)> accept;
+        double baseR = best.realizedScale;
+
+        switch (mode) {
+        case Mode::TargetTotalScale:
+            spec.reps = repsBand;
+            spec.totalScale = band(targetTotalScale, kAutoTuneSamples);
+            accept = [&](const CalculationResult& r) { return within(r.realizedScale, targetTotalScale); };
+            break;
+
+        case Mode::FixedBeatRatio:
+            spec.reps = repsBand;
+            spec.beatRatio = band(inputBeatRatio, kAutoTuneSamples);
+            accept = [&](const CalculationResult& r) { return within(r.realizedScale, baseR); };
+            break;
+
+        case Mode::MatchBeatEnd:
+            spec.reps = repsBand;
+            spec.beatEnd = band(inputBeatEnd, kAutoTuneSamples);
+            accept = [&](const CalculationResult& r) { return within(r.beatEnd, inputBeatEnd); };
+            break;
+
+        case Mode::FitToCurve:
+            spec.beatRatio = band(inputBeatRatio, kAutoTuneSamples2D);
+            spec.totalScale = band(targetTotalScale, kAutoTuneSamples2D);
+            accept = [&](const CalculationResult& r) { return within(r.realizedScale, targetTotalScale); };
+            break;
+
+        case Mode::FitEndAndRatio:
+            spec.beatEnd = band(inputBeatEnd, kAutoTuneSamples2D);
+            spec.totalScale = band(targetTotalScale, kAutoTuneSamples2D);
+            accept = [&](const CalculationResult& r) {
+                return within(r.realizedScale, targetTotalScale) && within(r.beatEnd, inputBeatEnd);
+                };
+            break;
+        }
+
+        double baseErrorMs = best.errorMs;
+        bool improved = false;
+
+        for (const auto& candidate : sweep(ctx, spec)) {
+            if (!candidate.success || !accept(candidate)) continue;
+            if (candidate.errorTicks < best.errorTicks) { best = candidate; improved = true; }
+        }
+
+        best.message = improved
+            ? "Auto-Tuned (drift " + std::to_string(baseErrorMs) + " -> " + std::to_string(best.errorMs) + " ms)"
+            : "Auto-Tune kept request (no better setting within tolerance)";
+        return best;
+    }
+}
@@ -3,8 +3,9 @@
     GeometricTimeSolver.h
 
     Core math for the geometric time stretching algorithms.
-    Stateless solver that handles the geometric series summation and
+    Solver that handles the geometric series summation and
     parameter estimation (bisection search) for the time-warping.
+    Per-model data lives in a SolverContext so repeated solves share it.
   ==============================================================================
 */
 #pragma once
@@ -13,6 +14,9 @@
 #include <algorithm>
 #include <limits>
 #include <string>
+#include <array>
+#include "TempoMap.h"
+#include "PerfStats.h"
 
 namespace GeoTimeMath
 {
@@ -28,6 +32,7 @@ namespace GeoTimeMath
         // --- Internal Engine State ---
         int repetitions = 0;        // (N) Total integer steps to generate
         double stepScale = 1.0;     // (s_step) Scale factor per single event step
+        int solverIterations = 0;   // Duration evaluations spent by the s_step search
 
         // --- Validation Stats ---
         double realizedScale = 0.0; // Actual R achieved after integer rounding
@@ -43,11 +48,159 @@ namespace GeoTimeMath
         FitEndAndRatio    // Fixed E, R -> Solve N
     };
 
+    /**
+     * Precomputed view of one delta pattern, built once per loaded model.
+     * Holds the deltas (the coefficients of the per-loop polynomial P(s)),
+     * their prefix sums, scratch space for the N searches and a small cache
+     * of recent results, so re-solving against the same model doesn't copy
+     * or re-scan anything.
+     */
+    class SolverContext
+    {
+    public:
+        SolverContext() { build({}, 0.0, TempoMap()); }
+
+        // An empty pattern falls back to a single 960 tick segment
+        void build(const std::vector<double>& segmentDeltas, double sourceDur, const TempoMap& tempoMap);
+
+        int getSegmentCount() const { return (int)deltas.size(); }
+        const std::vector<double>& getDeltas() const { return deltas; }
+        const std::vector<double>& getPrefixSums() const { return prefixSums; } // prefix[j] = Sum( delta[i], i < j )
+        const std::vector<double>& getDerivativeCoeffs() const { return derivativeCoeffs; } // j * delta[j]
+        double getSourceDuration() const { return sourceDuration; }
+
+        // All deltas equal: the duration is then a plain geometric series, evaluated in O(1)
+        bool isUniformGrid() const { return uniformGrid; }
+        const TempoMap& getTempoMap() const { return tempo; } // Source ticks -> ms
+
+        // Scratch buffer (M + 1 entries) used by the fixed-s duration evaluator
+        std::vector<double>& getScratch() const { return scratch; }
+
+        // Where the solver phases are timed (nullptr = not timed). Not rebuilt by build(), and
+        // copied along with the context: a copy solved on another thread should reset it.
+        void setStats(PerfStats* s) { stats = s; }
+        PerfStats* getStats() const { return stats; }
+
+        // Threads the drift verification of a long N may use (0 = one per core). Kept by build().
+        // Callers that already run several solves in parallel should budget this.
+        void setMaxThreads(int numThreads) { maxThreads = numThreads; }
+        int getMaxThreads() const { return maxThreads; }
+
+        // --- Result cache (keyed on mode, the inputs that mode reads and integer-loop flag) ---
+        struct CacheKey {
+            Mode mode = Mode::TargetTotalScale;
+            double reps = 0.0, beatRatio = 0.0, totalScale = 0.0, beatEnd = 0.0; // Unread inputs stay 0
+            bool integerReps = false;
+
+            static CacheKey make(Mode mode, double reps, double beatRatio, double totalScale, double beatEnd,
+                bool integerReps);
+
+            bool operator==(const CacheKey& o) const {
+                return mode == o.mode && reps == o.reps && beatRatio == o.beatRatio
+                    && totalScale == o.totalScale && beatEnd == o.beatEnd && integerReps == o.integerReps;
+            }
+        };
+
+        const CalculationResult* findCached(const CacheKey& key) const;
+        void storeCached(const CacheKey& key, const CalculationResult& result) const;
+        void clearCache() const;
+
+    private:
+        std::vector<double> deltas;
+        std::vector<double> prefixSums;
+        std::vector<double> derivativeCoeffs;
+        double sourceDuration = 0.0;
+        bool uniformGrid = false;
+        TempoMap tempo;
+        PerfStats* stats = nullptr;
+        int maxThreads = 0;
+
+        static const int kCacheSize = 8;
+        struct CacheEntry { CacheKey key; CalculationResult result; bool valid = false; };
+
+        mutable std::vector<double> scratch;
+        mutable std::array<CacheEntry, kCacheSize> cache;
+        mutable int nextCacheSlot = 0;
+    };
+
+    /**
+     * Walks s_step^k for k = 0, 1, 2, ... by multiplication instead of calling std::pow
+     * for every step, re-anchoring to the exact power every kReanchorInterval steps so the
+     * accumulated rounding stays orders of magnitude below one tick.
+     */
+    class StepScaleCursor
+    {
+    public:
+        explicit StepScaleCursor(double s_step, int firstStep = 0)
+            : stepScale(s_step), step(firstStep), scale(std::pow(s_step, firstStep)) {}
+
+        int getStep() const { return step; }
+        double getScale() const { return scale; } // s_step^step
+
+        void advance()
+        {
+            if (++step % kReanchorInterval == 0) scale = std::pow(stepScale, step);
+            else scale *= stepScale;
+        }
+
+    private:
+        static const int kReanchorInterval = 1024;
+
+        double stepScale;
+        int step;
+        double scale;
+    };
+
     /**
      * Solves the geometric series parameters.
      * * @param constrainToIntegerReps: Forces N to be a multiple of the segment count
      * (ensures we always end on a full loop boundary).
      */
+    CalculationResult solve(const SolverContext& context, Mode mode, double targetReps, double inputBeatRatio,
+        double targetTotalScale, double inputBeatEnd, bool constrainToIntegerReps);
+
+    // Convenience overload: builds a temporary context for a one-off solve
     CalculationResult solve(Mode mode, double targetReps, double inputBeatRatio, double targetTotalScale, double inputBeatEnd,
         const std::vector<double>& deltas, double sourceDur, double bpm, int ppq, bool constrainToIntegerReps);
+
+    // Inclusive, evenly spaced input range. count == 1 is just 'first'.
+    struct SweepRange {
+        double first = 0.0;
+        double last = 0.0;
+        int count = 1;
+
+        double valueAt(int i) const { return count > 1 ? first + (last - first) * (double)i / (double)(count - 1) : first; }
+    };
+
+    struct SweepSpec {
+        Mode mode = Mode::TargetTotalScale;
+        SweepRange reps, beatRatio, totalScale, beatEnd; // Ranges a mode doesn't read should keep count = 1
+        bool constrainToIntegerReps = false;
+
+        size_t size() const
+        {
+            if (reps.count < 1 || beatRatio.count < 1 || totalScale.count < 1 || beatEnd.count < 1) return 0;
+            return (size_t)reps.count * (size_t)beatRatio.count * (size_t)totalScale.count * (size_t)beatEnd.count;
+        }
+    };
+
+    /**
+     * Solves every combination of the sweep ranges against one context, e.g. to find the
+     * lowest-drift setting or plot drift against a parameter. Each entry equals what solve()
+     * returns for those inputs. Results are laid out with beatEnd varying fastest:
+     * index = ((iN * nS + iS) * nR + iR) * nE + iE.
+     * Bypasses the context's result cache.
+     */
+    std::vector<CalculationResult> sweep(const SolverContext& context, const SweepSpec& spec);
+
+    /**
+     * Drift auto-tune: sweeps the neighbourhood of the requested inputs and returns the setting
+     * with the smallest rounded-tick drift (errorTicks). 'tolerance' is relative (0.02 = 2%) and
+     * bounds what may move: R for the modes that lock R (for FixedBeatRatio, R as computed from the
+     * request), E for MatchBeatEnd, both for FitEndAndRatio. Modes with a fixed N also try
+     * neighbouring repetition counts (two steps, or one loop with integer loops, on each side).
+     * Returns the plain solve() result when nothing within tolerance beats it.
+     */
+    CalculationResult autoTune(const SolverContext& context, Mode mode, double targetReps, double inputBeatRatio,
+        double targetTotalScale, double inputBeatEnd, bool constrainToIntegerReps, double tolerance);
 }
\ No newline at end of file
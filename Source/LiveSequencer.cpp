@@ -0,0 +1,191 @@
+/*
+  ==============================================================================
+    LiveSequencer.cpp
+  ==============================================================================
+*/
+#include "LiveSequencer.h"
+
+std::unique_ptr<LiveSequencer::Snapshot> LiveSequencer::createSnapshot(std::shared_ptr<const MidiGridModel> model,
+                                                                       int totalSteps, double s_step)
+{
+    auto snapshot = std::make_unique<Snapshot>();
+    const auto& events = model->getEvents();
+    snapshot->steps.build(model->getDeltas(), totalSteps, s_step);
+
+    // A placement is at most two buckets (end of loop + start of the next one). Two placements
+    // can be waiting while a third is added.
+    size_t largestBucket = 0;
+    for (int b = 0; b < events.getNumBuckets(); ++b)
+        largestBucket = std::max(largestBucket, (size_t)events.getBucketSize(b));
+
+    snapshot->maxPlacementEvents = largestBucket * 2;
+    snapshot->pending.resize(snapshot->maxPlacementEvents * 3);
+    snapshot->model = std::move(model);
+    return snapshot;
+}
+
+LiveSequencer::~LiveSequencer()
+{
+    // The audio thread is gone by now
+    collectGarbage();
+    delete incoming.exchange(nullptr);
+    delete current;
+}
+
+void LiveSequencer::publish(std::unique_ptr<Snapshot> snapshot)
+{
+    jassert(snapshot != nullptr);
+
+    // One the audio thread never picked up can be freed straight away
+    delete incoming.exchange(snapshot.release(), std::memory_order_acq_rel);
+    collectGarbage();
+}
+
+void LiveSequencer::collectGarbage()
+{
+    retireFifo.read(retireFifo.getNumReady()).forEach([this](int index) {
+        delete retired[(size_t)index];
+        retired[(size_t)index] = nullptr;
+        });
+}
+
+void LiveSequencer::render(juce::MidiBuffer& out, int numSamples, double sampleRate, const Position& position)
+{
+    // Swap in a new snapshot only when the old one can be handed back without waiting
+    if (incoming.load(std::memory_order_relaxed) != nullptr && retireFifo.getFreeSpace() > 0) {
+        if (auto* next = incoming.exchange(nullptr, std::memory_order_acq_rel)) {
+            if (current != nullptr)
+                retireFifo.write(1).forEach([this](int index) { retired[(size_t)index] = current; });
+
+            current = next;
+            needsSeek = true;
+        }
+    }
+
+    if (current == nullptr || !position.isPlaying || numSamples <= 0 || sampleRate <= 0.0 || position.bpm <= 0.0) {
+        if (wasPlaying) allNotesOff(out);
+        wasPlaying = false;
+        return;
+    }
+
+    const auto& model = *current->model;
+    int ppq = model.getPPQ() > 0 ? model.getPPQ() : 960;
+
+    Block block;
+    block.ticksPerSample = position.bpm / 60.0 * ppq / sampleRate;
+    block.startTick = position.ppq * ppq;
+    block.endTick = block.startTick + numSamples * block.ticksPerSample;
+    block.numSamples = numSamples;
+
+    // Host jumps (locate, loop, start) restart the cursor at the new position. Small forward
+    // drift between blocks is followed without a seek: late events then go out at sample 0.
+    double drift = block.startTick - expectedTick;
+    if (!wasPlaying || needsSeek || drift < -1.0 || drift > std::max(1.0, numSamples * block.ticksPerSample)) {
+        if (wasPlaying) allNotesOff(out);
+        seek(block.startTick);
+    }
+
+    wasPlaying = true;
+    expectedTick = block.endTick;
+
+    emitDue(out, block);
+
+    // Events snap to their nearest grid line, so placement p can't produce anything before
+    // the start of step p - 1. Due events are emitted after each placement, which keeps the
+    // pending window to the placements that straddle the block end.
+    int numPlacements = current->steps.getNumSteps() + 1;
+
+    while (nextPlacement < numPlacements && (nextPlacement == 0 || stepCursor.getStartTime() < block.endTick)) {
+        // Back off rather than drop events; this placement is retried next block
+        if (current->pending.size() - numPending < current->maxPlacementEvents) break;
+
+        addPlacement(nextPlacement);
+        if (nextPlacement++ > 0) stepCursor.advance();
+        emitDue(out, block);
+    }
+}
+
+void LiveSequencer::seek(double tick)
+{
+    // Placements from the one before the step containing 'tick' can still reach it; anything
+    // earlier than 'tick' is skipped once, in emitDue()
+    const auto& steps = current->steps;
+    nextPlacement = std::max(0, steps.findStep(tick).getStep() - 1);
+    stepCursor = steps.getStep(std::max(0, nextPlacement - 1));
+
+    numPending = 0;
+    skipBefore = tick;
+    needsSeek = false;
+}
+
+void LiveSequencer::addPlacement(int placement)
+{
+    const auto& model = *current->model;
+    const auto& events = model.getEvents();
+    int segmentCount = (int)model.getDeltas().size();
+    int numBuckets = events.getNumBuckets();
+    int numTracks = model.getNumTracks();
+
+    // Placement k + 1 sits at the end of step k, where the cursor is
+    double baseTime = placement == 0 ? 0.0 : stepCursor.getEndTime();
+    double stepScale = placement == 0 ? 1.0 : stepCursor.getScale();
+    auto& pending = current->pending;
+
+    auto addBucket = [&](int bucket) {
+        for (int i = events.bucketBegin(bucket); i < events.bucketEnd(bucket) && numPending < pending.size(); ++i) {
+            // Tempo and other meta events mean nothing on a live MIDI output
+            if (events.isMetaEvent(i) || events.getTrackIndex(i) >= numTracks) continue;
+            pending[numPending++] = { baseTime + events.getGrooveOffset(i) * stepScale, i };
+        }
+    };
+
+    if (numBuckets == 0) return;
+    if (placement == 0) {
+        addBucket(0);
+        return;
+    }
+
+    // Same bucket sequence as walkSteps()
+    int nextBucketIdx = stepCursor.getSegment() + 1;
+
+    if (nextBucketIdx == segmentCount) {
+        if (segmentCount < numBuckets) addBucket(segmentCount);
+        if (stepCursor.getStep() < current->steps.getNumSteps() - 1) addBucket(0);
+    }
+    else if (nextBucketIdx < numBuckets) {
+        addBucket(nextBucketIdx);
+    }
+}
+
+void LiveSequencer::emitDue(juce::MidiBuffer& out, const Block& block)
+{
+    // Compacts in place so the events that stay keep production order
+    const auto& events = current->model->getEvents();
+    auto& pending = current->pending;
+    size_t kept = 0;
+
+    for (size_t i = 0; i < numPending; ++i) {
+        auto p = pending[i];
+        if (p.time >= block.endTick) {
+            pending[kept++] = p;
+            continue;
+        }
+        if (p.time < skipBefore) continue;
+
+        juce::uint8 scratch[3];
+        int size = 0;
+        const auto* data = events.getRawData(p.eventIndex, scratch, size);
+        int sample = juce::jlimit(0, block.numSamples - 1, (int)((p.time - block.startTick) / block.ticksPerSample));
+        out.addEvent(data, size, sample);
+    }
+
+    numPending = kept;
+}
+
+void LiveSequencer::allNotesOff(juce::MidiBuffer& out)
+{
+    for (int channel = 0; channel < 16; ++channel) {
+        const juce::uint8 message[] = { (juce::uint8)(0xb0 | channel), 123, 0 };
+        out.addEvent(message, 3, 0);
+    }
+}
@@ -0,0 +1,91 @@
+/*
+  ==============================================================================
+    LiveSequencer.h
+
+    Plays the geometric warp in real time, one audio block at a time.
+    Everything that depends on the parameters (the step-time table) is built
+    into a Snapshot off the audio thread, published from the message thread
+    and handed to the audio thread through an atomic pointer; replaced snapshots go back through a
+    lock-free FIFO and are freed on the message thread. render() only moves a
+    cursor over the placed buckets and fills a preallocated pending window, so
+    it never locks or allocates.
+  ==============================================================================
+*/
+#pragma once
+#include <JuceHeader.h>
+#include <array>
+#include <atomic>
+#include <memory>
+#include "MidiGridModel.h"
+#include "StepTimeTable.h"
+
+class LiveSequencer
+{
+public:
+    struct Snapshot {
+        std::shared_ptr<const MidiGridModel> model;
+        StepTimeTable steps;
+
+        // Events placed but not yet due. Due events are emitted after every placement, so at
+        // most the two placements that straddle the block end are waiting here.
+        struct Pending { double time; int eventIndex; };
+        std::vector<Pending> pending;
+        size_t maxPlacementEvents = 0;
+    };
+
+    // Any thread but the audio thread (O(N)). Same step arithmetic as MidiTransformEngine, so
+    // live and rendered timing agree.
+    static std::unique_ptr<Snapshot> createSnapshot(std::shared_ptr<const MidiGridModel> model,
+                                                    int totalSteps, double s_step);
+
+    LiveSequencer() = default;
+    ~LiveSequencer();
+
+    // Message thread: replaces the playing snapshot
+    void publish(std::unique_ptr<Snapshot> snapshot);
+
+    // Message thread: frees snapshots the audio thread has let go of. Call regularly.
+    void collectGarbage();
+
+    struct Position {
+        bool isPlaying = false;
+        double ppq = 0.0;   // Host position in quarter notes; output tick 0 is ppq 0
+        double bpm = 120.0;
+    };
+
+    // Audio thread: adds the events due in this block to 'out'
+    void render(juce::MidiBuffer& out, int numSamples, double sampleRate, const Position& position);
+
+    // Audio thread (or while it is stopped): forces a seek on the next block
+    void reset() { needsSeek = true; }
+
+private:
+    struct Block {
+        double startTick, endTick, ticksPerSample;
+        int numSamples;
+    };
+
+    void seek(double tick);
+    void addPlacement(int placement);
+    void emitDue(juce::MidiBuffer& out, const Block& block);
+    static void allNotesOff(juce::MidiBuffer& out);
+
+    static constexpr int kRetireCapacity = 16;
+
+    // Message thread -> audio thread
+    std::atomic<Snapshot*> incoming{ nullptr };
+
+    // Audio thread -> message thread
+    juce::AbstractFifo retireFifo{ kRetireCapacity };
+    std::array<Snapshot*, kRetireCapacity> retired{};
+
+    // Audio thread state
+    Snapshot* current = nullptr;
+    int nextPlacement = 0;      // Placement 0 is bucket 0 at tick 0; placement k + 1 follows step k
+    StepTimeTable::Cursor stepCursor; // At step nextPlacement - 1 (step 0 before placement 1)
+    size_t numPending = 0;
+    double expectedTick = 0.0;  // Where the previous block ended
+    double skipBefore = 0.0;    // After a seek, events before this were already in the past
+    bool wasPlaying = false;
+    bool needsSeek = true;
+};
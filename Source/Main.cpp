@@ -7,6 +7,7 @@
 
 #include <JuceHeader.h>
 #include "MainComponent.h"
+#include "BatchProcessor.h"
 
 class CycleSnapApp : public juce::JUCEApplication
 {
@@ -19,6 +20,14 @@ public:
 
     void initialise(const juce::String& commandLine) override
     {
+        // Headless batch mode: no window, process and exit with the batch's status
+        juce::ArgumentList args(getApplicationName(), getCommandLineParameterArray());
+        if (BatchProcessor::isBatchCommandLine(args)) {
+            setApplicationReturnValue(BatchProcessor::run(args));
+            quit();
+            return;
+        }
+
         mainWindow.reset(new MainWindow(getApplicationName()));
     }
 
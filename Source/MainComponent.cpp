@@ -8,6 +8,9 @@
 
 MainComponent::MainComponent()
 {
+    engine.setModelCache(&modelCache);
+    engine.setStatsEnabled(true); // Reported in the debug dump
+
     // --- Styles & Setup ---
     auto setupEditor = [&](juce::TextEditor& e, const juce::String& tip) {
         addAndMakeVisible(e);
@@ -21,6 +24,8 @@ MainComponent::MainComponent()
         e.setColour(juce::TextEditor::textColourId, cCyan);
         e.setColour(juce::TextEditor::outlineColourId, cFrame);
         e.setColour(juce::TextEditor::focusedOutlineColourId, cGreen);
+
+        e.onTextChange = [this] { scheduleLiveSolve(); };
         };
 
     auto setupLabel = [&](juce::Label& l) {
@@ -59,7 +64,7 @@ MainComponent::MainComponent()
     modeSelector.setColour(juce::ComboBox::outlineColourId, cFrame);
     modeSelector.setColour(juce::ComboBox::arrowColourId, cCyan);
     modeSelector.setTooltip("Select which variables are locked (Inputs) and which one to solve for.");
-    modeSelector.onChange = [this] { updateInputStates(); };
+    modeSelector.onChange = [this] { updateInputStates(); scheduleLiveSolve(); };
     modeSelector.setSelectedId(1);
 
     addAndMakeVisible(chkIntLoops);
@@ -67,6 +72,23 @@ MainComponent::MainComponent()
     chkIntLoops.setColour(juce::ToggleButton::tickColourId, cCyan);
     chkIntLoops.setToggleState(true, juce::dontSendNotification);
     chkIntLoops.setTooltip("If checked, 'Repetitions' will be rounded to the nearest whole number (full loops only).");
+    chkIntLoops.onClick = [this] { scheduleLiveSolve(); };
+
+    addAndMakeVisible(chkAutoTune);
+    chkAutoTune.setColour(juce::ToggleButton::textColourId, cGreen);
+    chkAutoTune.setColour(juce::ToggleButton::tickColourId, cCyan);
+    chkAutoTune.setTooltip("If checked, the solver searches nearby N / s for the lowest drift,\nkeeping the locked R or E within the tolerance.");
+    chkAutoTune.onClick = [this] { updateInputStates(); scheduleLiveSolve(); };
+
+    addAndMakeVisible(chkLiveSolve);
+    chkLiveSolve.setColour(juce::ToggleButton::textColourId, cGreen);
+    chkLiveSolve.setColour(juce::ToggleButton::tickColourId, cCyan);
+    chkLiveSolve.setTooltip("If checked, the solver re-runs in the background as you type\nand fills in the solved values once you pause.");
+    chkLiveSolve.onClick = [this] { scheduleLiveSolve(); };
+
+    setupLabel(lblTol);
+    setupEditor(inputTol, "Auto-Tune Tolerance (%).\nHow far R or E may move from the requested value.\n2.0 = within 2%.");
+    inputTol.setText("2.0");
 
     // --- Log Panel ---
     addAndMakeVisible(logEditor);
@@ -103,9 +125,16 @@ MainComponent::MainComponent()
     ejectButton.setColour(juce::TextButton::textColourOnId, cRed);
     ejectButton.setColour(juce::TextButton::buttonOnColourId, cRed.withAlpha(0.2f));
     ejectButton.onClick = [this] {
+        if (isBusy) return;
+        solutionReady = false;
+        generateButton.setEnabled(false);
+        saveButton.setEnabled(false);
         engine.loadSource(juce::File()); // Clearing the engine
+        liveContext.reset();
+        scheduleLiveSolve(); // Drops results in flight
+        setOutputCurve(nullptr);
         logMessage("DATA CLEARED.");
-        repaint();
+        repaintDataPort();
         };
 
     // --- Footer Actions ---
@@ -129,15 +158,34 @@ MainComponent::MainComponent()
     saveButton.setEnabled(false);
     saveButton.onClick = [this] { saveFile(); };
 
+    addChildComponent(abortButton); // Only shown while a job runs
+    abortButton.setColour(juce::TextButton::buttonColourId, cBackground);
+    abortButton.setColour(juce::TextButton::textColourOffId, cRed);
+    abortButton.setTooltip("Cancel the running operation.");
+    abortButton.onClick = [this] {
+        cancelRequested = true;
+        abortButton.setEnabled(false);
+        logMessage("ABORTING...");
+        };
+
     addAndMakeVisible(debugDumpToggle);
     debugDumpToggle.setColour(juce::ToggleButton::textColourId, cFrame);
     debugDumpToggle.setTooltip("Export a debug .txt file alongside the MIDI.");
 
+    setOpaque(true); // The background image covers every pixel
     setSize(700, 600);
     updateInputStates();
 }
 
-MainComponent::~MainComponent() {}
+MainComponent::~MainComponent()
+{
+    // Jobs capture 'this': stop them before any member goes away
+    stopTimer();
+    cancelRequested = true;
+    ++liveSolveGeneration;
+    workerPool.removeAllJobs(true, 10000);
+    liveSolvePool.removeAllJobs(true, 10000);
+}
 
 // --- Drawing Helpers ---
 
@@ -173,8 +221,37 @@ void MainComponent::drawChamferedPanel(juce::Graphics& g, juce::Rectangle<float>
     }
 }
 
-void MainComponent::paint(juce::Graphics& g)
+MainComponent::PanelLayout MainComponent::getPanelLayout() const
+{
+    PanelLayout layout;
+    auto area = getLocalBounds().toFloat().reduced(15);
+
+    layout.header = area.removeFromTop(30);
+    area.removeFromTop(10);
+    area.removeFromBottom(50); // Footer
+
+    // Grid Layout
+    auto topRow = area.removeFromTop(area.getHeight() * 0.35f);
+    area.removeFromTop(10);
+    auto botRow = area;
+
+    layout.dataPort = topRow.removeFromLeft(topRow.getWidth() * 0.4f);
+    topRow.removeFromLeft(10);
+    layout.visualizer = topRow;
+
+    layout.controlCore = botRow.removeFromLeft(botRow.getWidth() * 0.5f);
+    botRow.removeFromLeft(10);
+    layout.systemLog = botRow;
+    return layout;
+}
+
+void MainComponent::renderBackground(const PanelLayout& layout, int width, int height, float scale)
 {
+    backgroundImage = juce::Image(juce::Image::RGB, width, height, false);
+    backgroundScale = scale;
+
+    juce::Graphics g(backgroundImage);
+    g.addTransform(juce::AffineTransform::scale(scale));
     g.fillAll(cBackground);
 
     // CRT Scanline effect
@@ -182,88 +259,112 @@ void MainComponent::paint(juce::Graphics& g)
     for (int y = 0; y < getHeight(); y += 4)
         g.fillRect(0, y, getWidth(), 1);
 
-    auto area = getLocalBounds().toFloat().reduced(15);
-
     // Header
-    auto header = area.removeFromTop(30);
     g.setFont(headerFont);
     g.setColour(juce::Colours::white);
-    g.drawText("CYCLESNAP v1.0", header, juce::Justification::topLeft, true);
+    g.drawText("CYCLESNAP v1.0", layout.header, juce::Justification::topLeft, true);
 
     g.setColour(cFrame);
-    g.fillRect(header.getRight() - 100, header.getY() + 10, 100.0f, 10.0f);
+    g.fillRect(layout.header.getRight() - 100, layout.header.getY() + 10, 100.0f, 10.0f);
 
-    area.removeFromTop(10);
-    auto footer = area.removeFromBottom(50);
+    drawChamferedPanel(g, layout.dataPort, "DATA_PORT", cCyan);
+    drawChamferedPanel(g, layout.visualizer, "VISUALIZER", cGreen);
+    drawChamferedPanel(g, layout.controlCore, "CONTROL_CORE", cOrange);
+    drawChamferedPanel(g, layout.systemLog, "SYSTEM_LOG", cGreen);
+}
 
-    // Grid Layout
-    auto topRow = area.removeFromTop(area.getHeight() * 0.35f);
-    area.removeFromTop(10);
-    auto botRow = area;
+void MainComponent::paint(juce::Graphics& g)
+{
+    auto layout = getPanelLayout();
 
-    // --- Panel: Data Port ---
-    auto modA = topRow.removeFromLeft(topRow.getWidth() * 0.4f);
-    topRow.removeFromLeft(10);
-    drawChamferedPanel(g, modA, "DATA_PORT", cCyan);
+    // Static chrome: rendered once per size (in physical pixels) and blitted
+    float scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+    int w = juce::jmax(1, juce::roundToInt(getWidth() * scale));
+    int h = juce::jmax(1, juce::roundToInt(getHeight() * scale));
+    if (!backgroundImage.isValid() || backgroundScale != scale || backgroundImage.getWidth() != w || backgroundImage.getHeight() != h)
+        renderBackground(layout, w, h, scale);
 
-    // Data Port Internal Drawing
-    if (modA.getHeight() > 50) {
-        auto inner = modA.reduced(10);
-        inner.removeFromTop(20);
+    g.drawImage(backgroundImage, getLocalBounds().toFloat());
 
-        if (engine.isSourceLoaded()) {
-            g.setColour(cCyan);
-            g.setFont(dataFont);
-            g.drawText("MEDIA LOADED", inner.removeFromTop(20), juce::Justification::centred, true);
+    paintDataPort(g, layout.dataPort);
+    paintVisualizer(g, layout.visualizer, scale);
+}
 
-            g.setFont(labelFont);
-            g.setColour(cGreen);
+void MainComponent::paintDataPort(juce::Graphics& g, juce::Rectangle<float> modA)
+{
+    if (modA.getHeight() <= 50) return;
 
-            juce::String stats = "TRK: " + juce::String(engine.getSourceTrackCount()) + "\n" +
-                "BPM: " + juce::String(engine.getSourceBPM());
-            g.drawText(stats, inner, juce::Justification::centred, true);
-        }
-        else {
-            // Drop Zone visuals
-            float dashLen[] = { 4.0f, 4.0f };
-            juce::Path p;
-            p.addRectangle(inner.toFloat());
+    auto inner = modA.reduced(10);
+    inner.removeFromTop(20);
 
-            juce::Path dashedPath;
-            juce::PathStrokeType(2.0f).createDashedStroke(dashedPath, p, dashLen, 2);
+    if (engine.isSourceLoaded()) {
+        g.setColour(cCyan);
+        g.setFont(dataFont);
+        g.drawText("MEDIA LOADED", inner.removeFromTop(20), juce::Justification::centred, true);
 
-            g.setColour(cFrame);
-            g.fillPath(dashedPath);
+        g.setFont(labelFont);
+        g.setColour(cGreen);
 
-            if (isDragActive) {
-                g.setColour(cGreen);
-                g.drawText(">> DROP HERE <<", inner, juce::Justification::centred, true);
-            }
-            else {
-                g.setColour(cFrame);
-                g.drawText("DROP MIDI HERE", inner, juce::Justification::centred, true);
-            }
+        juce::String stats = "TRK: " + juce::String(engine.getSourceTrackCount()) + "\n" +
+            "BPM: " + juce::String(engine.getSourceBPM());
+        if (engine.getSourceTempoSegmentCount() > 1)
+            stats << "\nTEMPO MAP: " << engine.getSourceTempoSegmentCount() << " SEG";
+        g.drawText(stats, inner, juce::Justification::centred, true);
+    }
+    else {
+        // Drop Zone visuals
+        float dashLen[] = { 4.0f, 4.0f };
+        juce::Path p;
+        p.addRectangle(inner.toFloat());
+
+        juce::Path dashedPath;
+        juce::PathStrokeType(2.0f).createDashedStroke(dashedPath, p, dashLen, 2);
+
+        g.setColour(cFrame);
+        g.fillPath(dashedPath);
+
+        if (isDragActive) {
+            g.setColour(cGreen);
+            g.drawText(">> DROP HERE <<", inner, juce::Justification::centred, true);
+        }
+        else {
+            g.setColour(cFrame);
+            g.drawText("DROP MIDI HERE", inner, juce::Justification::centred, true);
         }
     }
+}
 
-    // --- Panel: Visualizer ---
-    auto modC = topRow;
-    drawChamferedPanel(g, modC, "VISUALIZER", cGreen);
+void MainComponent::paintVisualizer(juce::Graphics& g, juce::Rectangle<float> modC, float scale)
+{
+    auto plot = modC.reduced(10);
+    plot.removeFromTop(25);
+
+    if (outputCurve == nullptr || plot.getWidth() < 10 || plot.getHeight() < 10) {
+        // Placeholder content
+        g.setColour(cFrame.darker(0.5f));
+        g.drawRect(modC.reduced(20).toFloat(), 1.0f);
+        g.setColour(cFrame);
+        g.drawText("[ OFFLINE ]", modC, juce::Justification::centred, true);
+        return;
+    }
 
-    // Placeholder content
-    g.setColour(cFrame.darker(0.5f));
-    g.drawRect(modC.reduced(20).toFloat(), 1.0f);
-    g.setColour(cFrame);
-    g.drawText("[ OFFLINE ]", modC, juce::Justification::centred, true);
+    // The image is kept in physical pixels, so it stays sharp on high-DPI displays
+    int w = juce::roundToInt(plot.getWidth() * scale);
+    int h = juce::roundToInt(plot.getHeight() * scale);
+    if (!visualizerImage.isValid() || visualizerImage.getWidth() != w || visualizerImage.getHeight() != h)
+        renderVisualizer(w, h);
 
-    // --- Panel: Control Core ---
-    auto modB = botRow.removeFromLeft(botRow.getWidth() * 0.5f);
-    botRow.removeFromLeft(10);
-    drawChamferedPanel(g, modB, "CONTROL_CORE", cOrange);
+    g.drawImage(visualizerImage, plot);
 
-    // --- Panel: System Log ---
-    auto modD = botRow;
-    drawChamferedPanel(g, modD, "SYSTEM_LOG", cGreen);
+    g.setFont(labelFont);
+    g.setColour(cCyan.withAlpha(0.7f));
+    g.drawText("STEPS " + juce::String(outputCurve->getNumSteps()) + "  EVT " + juce::String(outputCurve->getNumEvents()),
+        plot.removeFromTop(14), juce::Justification::topRight, false);
+}
+
+void MainComponent::repaintDataPort()
+{
+    repaint(getPanelLayout().dataPort.getSmallestIntegerContainer());
 }
 
 void MainComponent::resized()
@@ -293,7 +394,9 @@ void MainComponent::resized()
 
     modeSelector.setBounds(modB.removeFromTop(25));
     modB.removeFromTop(10);
-    chkIntLoops.setBounds(modB.removeFromTop(20));
+    auto chkRow = modB.removeFromTop(20);
+    chkIntLoops.setBounds(chkRow.removeFromLeft(chkRow.getWidth() / 2));
+    chkAutoTune.setBounds(chkRow);
     modB.removeFromTop(15);
 
     auto grid = modB;
@@ -313,6 +416,14 @@ void MainComponent::resized()
     r2.removeFromLeft(10);
     lblSend.setBounds(r2.removeFromTop(20)); inputSend.setBounds(r2);
 
+    grid.removeFromTop(10);
+
+    auto r3 = grid.removeFromTop(rowH);
+    auto c5 = r3.removeFromLeft(r3.getWidth() / 2 - 5);
+    lblTol.setBounds(c5.removeFromTop(20)); inputTol.setBounds(c5);
+    r3.removeFromLeft(10);
+    chkLiveSolve.setBounds(r3.removeFromBottom(c5.getHeight()));
+
     // Logs
     auto modD = botRow;
     modD.reduce(15, 15);
@@ -332,6 +443,79 @@ void MainComponent::resized()
     saveButton.setBounds(generateButton.getRight() + gap, btnArea.getY(), btnW, 40);
 
     debugDumpToggle.setBounds(saveButton.getRight() + 20, btnArea.getY(), 100, 40);
+    abortButton.setBounds(btnArea.getRight() - 80, btnArea.getY(), 80, 40);
+}
+
+void MainComponent::renderVisualizer(int width, int height)
+{
+    visualizerImage = juce::Image(juce::Image::ARGB, width, height, true);
+    juce::Graphics g(visualizerImage);
+
+    // One column per pixel, each merging the (at most two) bins of the chosen level under it
+    const auto& bins = outputCurve->getLevelFor(width);
+    int numBins = (int)bins.size();
+
+    std::vector<OutputCurve::Bin> columns((size_t)width);
+    uint32_t maxEvents = 1;
+    for (int x = 0; x < width; ++x) {
+        int first = x * numBins / width;
+        int last = std::max(first + 1, (x + 1) * numBins / width);
+        auto& col = columns[(size_t)x];
+
+        for (int b = first; b < last; ++b) {
+            const auto& bin = bins[(size_t)b];
+            col.events += bin.events;
+            if (bin.maxDuration == 0.0f) continue;
+            col.minDuration = col.maxDuration == 0.0f ? bin.minDuration : std::min(col.minDuration, bin.minDuration);
+            col.maxDuration = std::max(col.maxDuration, bin.maxDuration);
+        }
+        maxEvents = std::max(maxEvents, col.events);
+    }
+
+    // Event density along the bottom third, step duration (log scale) above it
+    int densityHeight = height / 3;
+    int curveHeight = height - densityHeight - 4;
+
+    double lo = std::log(std::max(outputCurve->getMinDuration(), 1e-9));
+    double hi = std::log(std::max(outputCurve->getMaxDuration(), 1e-9));
+    auto curveY = [&](float duration) {
+        if (hi - lo < 1e-9) return curveHeight / 2;
+        double t = (std::log(std::max((double)duration, 1e-9)) - lo) / (hi - lo);
+        return juce::roundToInt((1.0 - t) * (curveHeight - 1));
+        };
+
+    for (int x = 0; x < width; ++x) {
+        const auto& col = columns[(size_t)x];
+
+        if (col.events > 0) {
+            int barHeight = std::max(1, (int)((double)col.events / maxEvents * densityHeight));
+            g.setColour(cFrame.brighter(0.5f));
+            g.fillRect(x, height - barHeight, 1, barHeight);
+        }
+
+        if (col.maxDuration > 0.0f) {
+            int top = curveY(col.maxDuration);
+            int bottom = curveY(col.minDuration);
+            g.setColour(cGreen);
+            g.fillRect(x, top, 1, bottom - top + 1);
+        }
+    }
+}
+
+void MainComponent::setOutputCurve(std::shared_ptr<const OutputCurve> curve)
+{
+    outputCurve = std::move(curve);
+    visualizerImage = juce::Image();
+    repaint(getPanelLayout().visualizer.getSmallestIntegerContainer());
+}
+
+std::shared_ptr<const OutputCurve> MainComponent::buildOutputCurve(int steps, double stepScale)
+{
+    // Only polled for ABORT: the job's own progress reporting is left to the solve/generate
+    auto curve = std::make_shared<OutputCurve>();
+    auto res = engine.buildOutputCurve(steps, stepScale, *curve,
+        [this](double) { return !cancelRequested.load(); });
+    return res.wasOk() ? curve : nullptr;
 }
 
 // --- Logic Implementation ---
@@ -355,6 +539,7 @@ void MainComponent::updateInputStates()
     setFieldState(inputS, S_Enabled);
     setFieldState(inputR, R_Enabled);
     setFieldState(inputSend, End_Enabled);
+    setFieldState(inputTol, chkAutoTune.getToggleState());
 }
 
 void MainComponent::updateErrorDisplay(double errorMs)
@@ -367,100 +552,293 @@ void MainComponent::updateErrorDisplay(double errorMs)
     else                     lblErrorMonitor.setColour(juce::Label::textColourId, cRed);
 }
 
+double MainComponent::getAutoTuneTolerance() const
+{
+    if (!chkAutoTune.getToggleState()) return 0.0;
+    return juce::jmax(0.0, inputTol.getText().getDoubleValue() / 100.0);
+}
+
 void MainComponent::logMessage(const juce::String& msg)
 {
     logEditor.moveCaretToEnd();
     logEditor.insertTextAtCaret(">> " + msg + "\n");
 }
 
+// --- Background Jobs ---
+
+void MainComponent::runInBackground(const juce::String& taskName, std::function<std::function<void()>()> work)
+{
+    if (isBusy) return;
+
+    busyTaskName = taskName;
+    setBusy(true);
+
+    workerPool.addJob([this, work] {
+        auto onDone = work();
+
+        juce::MessageManager::callAsync([safeThis = juce::Component::SafePointer<MainComponent>(this), onDone] {
+            if (safeThis == nullptr) return;
+            safeThis->setBusy(false);
+            if (onDone) onDone();
+            });
+        });
+}
+
+void MainComponent::setBusy(bool shouldBeBusy)
+{
+    isBusy = shouldBeBusy;
+
+    if (isBusy) {
+        jobProgress = 0.0;
+        cancelRequested = false;
+        lastLoggedPercent = -1;
+        logMessage(busyTaskName + "...");
+        startTimer(100);
+    }
+    else {
+        stopTimer();
+    }
+
+    solveButton.setEnabled(!isBusy);
+    generateButton.setEnabled(!isBusy && solutionReady);
+    saveButton.setEnabled(!isBusy && engine.isOutputReady());
+    loadButton.setEnabled(!isBusy);
+    ejectButton.setEnabled(!isBusy);
+
+    abortButton.setEnabled(isBusy);
+    abortButton.setVisible(isBusy);
+}
+
+MidiTransformEngine::ProgressCallback MainComponent::makeProgressCallback()
+{
+    // Called on the worker thread
+    return [this](double fraction) {
+        jobProgress = fraction;
+        return !cancelRequested.load();
+        };
+}
+
+void MainComponent::timerCallback()
+{
+    // Log progress in 10% steps
+    int percent = (int)(jobProgress.load() * 10.0) * 10;
+    if (percent > lastLoggedPercent && percent > 0 && percent < 100) {
+        logMessage(busyTaskName + " " + juce::String(percent) + "%");
+        lastLoggedPercent = percent;
+    }
+}
+
 void MainComponent::loadFile(const juce::File& file) {
+    if (isBusy) { logMessage("ERROR: BUSY."); return; }
+
     logMessage("ACCESSING: " + file.getFileName());
     auto res = engine.loadSource(file);
+    setOutputCurve(nullptr);
+    liveContext = nullptr;
+    if (res.wasOk()) {
+        // Live solves run on their own thread, so they don't feed the engine's stats
+        auto context = std::make_shared<GeoTimeMath::SolverContext>(engine.getSolverContext());
+        context->setStats(nullptr);
+        liveContext = context;
+    }
+    scheduleLiveSolve();
     if (res.wasOk()) {
         logMessage("SOURCE LOADED.");
+        solutionReady = false;
         generateButton.setEnabled(false);
         saveButton.setEnabled(false);
     }
     else {
         logMessage("ERROR: " + res.getErrorMessage());
     }
-    repaint();
+    repaintDataPort();
+}
+
+GeoTimeMath::Mode MainComponent::getSelectedMode() const
+{
+    switch (modeSelector.getSelectedId()) {
+    case 2: return GeoTimeMath::Mode::FixedBeatRatio;
+    case 3: return GeoTimeMath::Mode::MatchBeatEnd;
+    case 4: return GeoTimeMath::Mode::FitToCurve;
+    case 5: return GeoTimeMath::Mode::FitEndAndRatio;
+    default: return GeoTimeMath::Mode::TargetTotalScale;
+    }
 }
 
 void MainComponent::runSolver() {
     if (!engine.isSourceLoaded()) { logMessage("ERROR: NO SOURCE."); return; }
-    logMessage("CALCULATING...");
 
     double reps = inputN.getText().getDoubleValue();
     double s = inputS.getText().getDoubleValue();
     double R = inputR.getText().getDoubleValue();
     double end = inputSend.getText().getDoubleValue();
     bool integerLoops = chkIntLoops.getToggleState();
+    double tolerance = getAutoTuneTolerance();
 
-    auto mode = GeoTimeMath::Mode::TargetTotalScale;
-    switch (modeSelector.getSelectedId()) {
-    case 1: mode = GeoTimeMath::Mode::TargetTotalScale; break;
-    case 2: mode = GeoTimeMath::Mode::FixedBeatRatio; break;
-    case 3: mode = GeoTimeMath::Mode::MatchBeatEnd; break;
-    case 4: mode = GeoTimeMath::Mode::FitToCurve; break;
-    case 5: mode = GeoTimeMath::Mode::FitEndAndRatio; break;
-    }
+    auto mode = getSelectedMode();
 
-    auto result = engine.runSolver(mode, reps, s, R, end, integerLoops);
+    runInBackground("CALCULATING", [this, mode, reps, s, R, end, integerLoops, tolerance]() -> std::function<void()> {
+        auto result = engine.runSolver(mode, reps, s, R, end, integerLoops, tolerance);
+        auto curve = result.success ? buildOutputCurve(result.repetitions, result.stepScale) : nullptr;
 
-    if (result.success) {
-        int M = engine.getSegmentCount(); if (M < 1) M = 1;
-        double displayLoops = (double)result.repetitions / M;
+        return [this, result, tolerance, curve] {
+            if (cancelRequested) { logMessage("CALCULATION ABORTED."); return; }
 
-        logMessage(juce::String("SOLVED: N=") + juce::String(result.repetitions) +
-            " (" + juce::String(displayLoops, 2) + " Loops)");
+            if (result.success) {
+                if (tolerance > 0.0) logMessage(juce::String(result.message).toUpperCase());
 
-        updateErrorDisplay(result.errorMs);
+                int M = engine.getSegmentCount(); if (M < 1) M = 1;
+                double displayLoops = (double)result.repetitions / M;
 
-        // Feedback calculated values to inputs
-        inputN.setText(juce::String(displayLoops, 2));
-        inputS.setText(juce::String(result.beatRatio, 5));
-        inputR.setText(juce::String(result.totalScale, 5));
-        inputSend.setText(juce::String(result.beatEnd, 5));
+                logMessage(juce::String("SOLVED: N=") + juce::String(result.repetitions) +
+                    " (" + juce::String(displayLoops, 2) + " Loops)");
 
-        generateButton.setEnabled(true);
+                updateErrorDisplay(result.errorMs);
+
+                // Feedback calculated values to inputs
+                // Without change notifications, so live mode doesn't re-solve its own output
+                inputN.setText(juce::String(displayLoops, 2), false);
+                inputS.setText(juce::String(result.beatRatio, 5), false);
+                inputR.setText(juce::String(result.totalScale, 5), false);
+                inputSend.setText(juce::String(result.beatEnd, 5), false);
+
+                setOutputCurve(curve);
+                solvedResult = result;
+                solutionReady = true;
+                generateButton.setEnabled(true);
+            }
+            else {
+                logMessage("MATH ERROR: " + juce::String(result.message));
+                updateErrorDisplay(999.0);
+            }
+            };
+        });
+}
+
+// --- Live Solve ---
+
+void MainComponent::scheduleLiveSolve()
+{
+    // Any edit makes results in flight stale, live mode or not, and the kept solve no longer
+    // matches the inputs
+    ++liveSolveGeneration;
+    liveResult.reset();
+    solvedResult.reset();
+
+    if (!chkLiveSolve.getToggleState() || liveContext == nullptr) {
+        liveSolveTimer.stopTimer();
+        liveCommitTimer.stopTimer();
+        return;
     }
-    else {
+
+    liveSolveTimer.startTimer(kLiveSolveDelayMs);
+    liveCommitTimer.startTimer(kLiveCommitDelayMs);
+}
+
+void MainComponent::launchLiveSolve()
+{
+    liveSolveTimer.stopTimer();
+    if (liveContext == nullptr) return;
+
+    double reps = inputN.getText().getDoubleValue();
+    double s = inputS.getText().getDoubleValue();
+    double R = inputR.getText().getDoubleValue();
+    double end = inputSend.getText().getDoubleValue();
+    bool integerLoops = chkIntLoops.getToggleState();
+    double tolerance = getAutoTuneTolerance();
+    auto mode = getSelectedMode();
+
+    int generation = liveSolveGeneration.load();
+    auto context = liveContext;
+
+    liveSolvePool.addJob([this, generation, context, mode, reps, s, R, end, integerLoops, tolerance] {
+        if (generation != liveSolveGeneration.load()) return; // Superseded while queued
+
+        auto result = tolerance > 0.0
+            ? GeoTimeMath::autoTune(*context, mode, reps, s, R, end, integerLoops, tolerance)
+            : GeoTimeMath::solve(*context, mode, reps, s, R, end, integerLoops);
+
+        juce::MessageManager::callAsync([safeThis = juce::Component::SafePointer<MainComponent>(this), generation, result] {
+            if (safeThis == nullptr || generation != safeThis->liveSolveGeneration.load()) return;
+
+            safeThis->liveResult = result;
+            safeThis->updateErrorDisplay(result.success ? result.errorMs : 999.0);
+
+            // The user stopped typing before the solve finished
+            if (!safeThis->liveCommitTimer.isTimerRunning()) safeThis->commitLiveResult();
+            });
+        });
+}
+
+void MainComponent::commitLiveResult()
+{
+    liveCommitTimer.stopTimer();
+    if (!liveResult.has_value()) return; // Still solving: the result commits itself on arrival
+
+    auto result = *liveResult;
+    liveResult.reset();
+
+    if (!result.success) {
         logMessage("MATH ERROR: " + juce::String(result.message));
-        updateErrorDisplay(999.0);
+        solutionReady = false;
+        generateButton.setEnabled(false);
+        return;
     }
+
+    // Only the solved (locked) fields: the ones being typed into keep the user's text
+    int M = engine.getSegmentCount(); if (M < 1) M = 1;
+    if (!inputN.isEnabled()) inputN.setText(juce::String((double)result.repetitions / M, 2), false);
+    if (!inputS.isEnabled()) inputS.setText(juce::String(result.beatRatio, 5), false);
+    if (!inputR.isEnabled()) inputR.setText(juce::String(result.totalScale, 5), false);
+    if (!inputSend.isEnabled()) inputSend.setText(juce::String(result.beatEnd, 5), false);
+
+    solvedResult = result;
+    solutionReady = true;
+    generateButton.setEnabled(!isBusy);
 }
 
 void MainComponent::generate() {
+    // Generate exactly what was solved (auto-tuned included). Only inputs edited since then
+    // are solved again, from their text, the way Calculate would.
+    auto solved = solvedResult;
+
     double reps = inputN.getText().getDoubleValue();
     double s = inputS.getText().getDoubleValue();
     double R = inputR.getText().getDoubleValue();
     double end = inputSend.getText().getDoubleValue();
     bool integerLoops = chkIntLoops.getToggleState();
+    double tolerance = getAutoTuneTolerance();
 
-    auto mode = GeoTimeMath::Mode::TargetTotalScale;
-    switch (modeSelector.getSelectedId()) {
-    case 1: mode = GeoTimeMath::Mode::TargetTotalScale; break;
-    case 2: mode = GeoTimeMath::Mode::FixedBeatRatio; break;
-    case 3: mode = GeoTimeMath::Mode::MatchBeatEnd; break;
-    case 4: mode = GeoTimeMath::Mode::FitToCurve; break;
-    case 5: mode = GeoTimeMath::Mode::FitEndAndRatio; break;
-    }
+    auto mode = getSelectedMode();
 
-    auto res = engine.runSolver(mode, reps, s, R, end, integerLoops);
+    runInBackground("GENERATING", [this, solved, mode, reps, s, R, end, integerLoops, tolerance]() -> std::function<void()> {
+        auto res = solved.has_value() ? *solved : engine.runSolver(mode, reps, s, R, end, integerLoops, tolerance);
+        if (!res.success)
+            return [this] { logMessage("GEN FAIL: Invalid Parameters."); };
 
-    if (res.success) {
-        if (engine.generateOutput(res.repetitions, res.stepScale).wasOk()) {
-            logMessage("SEQUENCE GENERATED.");
-            saveButton.setEnabled(true);
-        }
-        else {
-            logMessage("GEN FAIL: Engine Error.");
-        }
-    }
-    else {
-        logMessage("GEN FAIL: Invalid Parameters.");
-    }
+        auto gen = engine.generateOutput(res.repetitions, res.stepScale, makeProgressCallback());
+        auto reused = engine.getLastReusedEventCount();
+        auto created = engine.getLastCreatedEventCount();
+
+        // A kept solve already has its curve on screen
+        auto curve = gen.wasOk() && !solved.has_value() ? buildOutputCurve(res.repetitions, res.stepScale) : nullptr;
+
+        return [this, gen, reused, created, curve] {
+            if (gen.wasOk()) {
+                if (curve != nullptr) setOutputCurve(curve);
+                logMessage("SEQUENCE GENERATED.");
+                if (reused > 0)
+                    logMessage("REUSED " + juce::String(reused) + " EVENTS, " + juce::String(created) + " NEW.");
+                saveButton.setEnabled(true);
+            }
+            else if (cancelRequested) {
+                logMessage("GENERATION ABORTED.");
+            }
+            else {
+                logMessage("GEN FAIL: Engine Error.");
+            }
+            };
+        });
 }
 
 void MainComponent::saveFile() {
@@ -470,31 +848,44 @@ void MainComponent::saveFile() {
     fc->launchAsync(juce::FileBrowserComponent::saveMode | juce::FileBrowserComponent::canSelectFiles,
         [this, fc](const juce::FileChooser& chooser) {
             auto resultFile = chooser.getResult();
-            if (resultFile != juce::File()) {
-                if (engine.saveFile(resultFile).wasOk()) {
-                    logMessage("SAVED: " + resultFile.getFileName());
-
-                    if (debugDumpToggle.getToggleState()) {
-                        resultFile.withFileExtension("txt")
-                            .replaceWithText(engine.getDebugDump());
-                        logMessage("DEBUG DUMP EXPORTED.");
+            if (resultFile == juce::File()) return;
+
+            bool dumpDebug = debugDumpToggle.getToggleState();
+
+            runInBackground("SAVING", [this, resultFile, dumpDebug]() -> std::function<void()> {
+                auto res = engine.saveFile(resultFile, makeProgressCallback());
+
+                bool dumped = false;
+                if (res.wasOk() && dumpDebug)
+                    dumped = resultFile.withFileExtension("txt").replaceWithText(engine.getDebugDump());
+
+                return [this, res, resultFile, dumped] {
+                    if (res.wasOk()) {
+                        logMessage("SAVED: " + resultFile.getFileName());
+                        if (dumped) logMessage("DEBUG DUMP EXPORTED.");
                     }
-                }
-            }
+                    else if (cancelRequested) {
+                        logMessage("SAVE ABORTED.");
+                    }
+                    else {
+                        logMessage("SAVE FAIL: " + res.getErrorMessage());
+                    }
+                    };
+                });
         });
 }
 
 // --- Drag and Drop ---
 bool MainComponent::isInterestedInFileDrag(const juce::StringArray& files) {
-    return files.size() == 1 && files[0].endsWithIgnoreCase(".mid");
+    return !isBusy && files.size() == 1 && files[0].endsWithIgnoreCase(".mid");
 }
 void MainComponent::fileDragEnter(const juce::StringArray&, int, int) {
-    isDragActive = true; repaint();
+    isDragActive = true; repaintDataPort();
 }
 void MainComponent::fileDragExit(const juce::StringArray&) {
-    isDragActive = false; repaint();
+    isDragActive = false; repaintDataPort();
 }
 void MainComponent::filesDropped(const juce::StringArray& files, int, int) {
-    isDragActive = false; repaint();
+    isDragActive = false; repaintDataPort();
     if (files.size() > 0) loadFile(juce::File(files[0]));
 }
\ No newline at end of file
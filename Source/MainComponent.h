@@ -11,7 +11,8 @@
 #include "MidiTransformEngine.h"
 
 class MainComponent : public juce::Component,
-    public juce::FileDragAndDropTarget
+    public juce::FileDragAndDropTarget,
+    private juce::Timer
 {
 public:
     MainComponent();
@@ -30,15 +31,68 @@ private:
     // Logic
     void loadFile(const juce::File& file);
     void runSolver();
+    GeoTimeMath::Mode getSelectedMode() const;
     void generate();
     void saveFile();
     void logMessage(const juce::String& msg);
     void updateInputStates();
     void updateErrorDisplay(double errorMs);
-
+    void setOutputCurve(std::shared_ptr<const OutputCurve> curve);
+    std::shared_ptr<const OutputCurve> buildOutputCurve(int steps, double stepScale); // Worker thread
+    double getAutoTuneTolerance() const; // 0 when auto-tune is off
+
+    // Background work
+    // Solve/generate/save run on a single worker thread. While a job runs, every control that
+    // touches the engine is disabled, so the engine belongs to exactly one thread at a time.
+    // 'work' runs on the worker; the closure it returns runs on the message thread afterwards.
+    void runInBackground(const juce::String& taskName, std::function<std::function<void()>()> work);
+    void setBusy(bool shouldBeBusy);
+    MidiTransformEngine::ProgressCallback makeProgressCallback();
+    void timerCallback() override;
+
+    ModelCache modelCache{ ModelCache::getDefaultDirectory() };
     MidiTransformEngine engine;
     bool isDragActive = false;
 
+    juce::ThreadPool workerPool{ juce::ThreadPoolOptions{}.withThreadName("CycleSnap Worker").withNumberOfThreads(1) };
+    std::atomic<double> jobProgress{ 0.0 };
+    std::atomic<bool> cancelRequested{ false };
+    bool isBusy = false;
+    bool solutionReady = false;
+
+    // The last solve (or committed live solve), exactly as solved: its values are only shown
+    // rounded in the editors, so Generate uses this instead of re-solving from their text.
+    // Any edit clears it.
+    std::optional<GeoTimeMath::CalculationResult> solvedResult;
+    juce::String busyTaskName;
+    int lastLoggedPercent = -1;
+
+    // Live solve
+    // Edits restart a short debounce; the solve then runs on its own thread against a copy of
+    // the model's solver context (never the engine), so typing is never blocked. Every edit
+    // bumps liveSolveGeneration: stale jobs skip their work and their results are dropped.
+    // Solved values go back into the editors only once the user has stopped typing.
+    void scheduleLiveSolve();
+    void launchLiveSolve();
+    void commitLiveResult();
+
+    std::shared_ptr<const GeoTimeMath::SolverContext> liveContext; // Copied on load
+    std::atomic<int> liveSolveGeneration{ 0 };
+    std::optional<GeoTimeMath::CalculationResult> liveResult; // Latest current result
+    juce::TimedCallback liveSolveTimer{ [this] { launchLiveSolve(); } };
+    juce::TimedCallback liveCommitTimer{ [this] { commitLiveResult(); } };
+    juce::ThreadPool liveSolvePool{ juce::ThreadPoolOptions{}.withThreadName("CycleSnap Live Solve").withNumberOfThreads(1) };
+
+    static constexpr int kLiveSolveDelayMs = 150;
+    static constexpr int kLiveCommitDelayMs = 800;
+
+    // Visualizer
+    // The curve is built on the worker after every solve; paint() only blits the image,
+    // which is re-rendered from the curve when it changes or the panel is resized.
+    std::shared_ptr<const OutputCurve> outputCurve;
+    juce::Image visualizerImage;
+    void renderVisualizer(int width, int height);
+
     // UI Components
     juce::TooltipWindow tooltipWindow{ this, 700 };
 
@@ -58,6 +112,11 @@ private:
     juce::Label lblMode{ "lblMode", "OPERATION MODE" };
     juce::ComboBox modeSelector;
     juce::ToggleButton chkIntLoops{ "INT LOOPS LOCK" };
+    juce::ToggleButton chkAutoTune{ "AUTO-TUNE DRIFT" };
+    juce::ToggleButton chkLiveSolve{ "LIVE SOLVE" };
+
+    juce::Label lblTol{ "lblTol", "TOLERANCE [%]" };
+    juce::TextEditor inputTol;
 
     // Monitoring
     juce::Label lblErrorMonitor;
@@ -70,6 +129,7 @@ private:
     juce::TextButton solveButton{ "CALCULATE" };
     juce::TextButton generateButton{ "GENERATE" };
     juce::TextButton saveButton{ "SAVE DISK" };
+    juce::TextButton abortButton{ "ABORT" };
 
     juce::ToggleButton debugDumpToggle{ "DUMP .TXT" };
 
@@ -86,6 +146,21 @@ private:
     const juce::Colour cOrange{ 0xffffaa00 };
     const juce::Colour cRed{ 0xffff0000 };
 
+    // Drawing
+    // The chrome (scanlines, header, panel frames) is rendered once per size into
+    // backgroundImage; paint() blits it and draws only the data port and visualizer.
+    struct PanelLayout {
+        juce::Rectangle<float> header, dataPort, visualizer, controlCore, systemLog;
+    };
+    PanelLayout getPanelLayout() const;
+
+    juce::Image backgroundImage;
+    float backgroundScale = 0.0f;
+    void renderBackground(const PanelLayout& layout, int width, int height, float scale);
+
+    void paintDataPort(juce::Graphics& g, juce::Rectangle<float> bounds);
+    void paintVisualizer(juce::Graphics& g, juce::Rectangle<float> bounds, float scale);
+    void repaintDataPort();
     void drawChamferedPanel(juce::Graphics& g, juce::Rectangle<float> bounds, const juce::String& title, juce::Colour color);
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MainComponent)
@@ -0,0 +1,345 @@
+/*
+  ==============================================================================
+    MappedMidiFile.cpp
+  ==============================================================================
+*/
+#include "MappedMidiFile.h"
+
+namespace
+{
+    struct VariableLength { int value = 0; int bytesUsed = 0; };
+
+    // MidiMessage::readVariableLengthValue: at most 4 bytes, bytesUsed == 0 when malformed
+    VariableLength readVariableLength(const juce::uint8* data, int maxBytes)
+    {
+        uint32_t v = 0;
+        int limit = std::min(maxBytes, 4);
+
+        for (int used = 0; used < limit; ++used) {
+            auto byte = data[used];
+            v = (v << 7) + (byte & 0x7f);
+            if (!(byte & 0x80)) return { (int)v, used + 1 };
+        }
+        return {};
+    }
+
+    // MidiMessage::getMessageLengthFromFirstByte
+    int shortMessageLength(juce::uint8 status)
+    {
+        if (status < 0xc0 || (status >= 0xe0 && status < 0xf0)) return 3;
+        if (status < 0xe0) return 2;
+        if (status == 0xf1 || status == 0xf3) return 2;
+        if (status == 0xf2) return 3;
+        return 1;
+    }
+
+    bool readBigEndian(const juce::uint8*& data, size_t& remaining, int numBytes, uint32_t& value)
+    {
+        if (remaining < (size_t)numBytes) return false;
+
+        value = 0;
+        for (int i = 0; i < numBytes; ++i) value = (value << 8) | data[i];
+        data += numBytes;
+        remaining -= (size_t)numBytes;
+        return true;
+    }
+
+    constexpr uint32_t fourCC(const char* id)
+    {
+        return ((uint32_t)(juce::uint8)id[0] << 24) | ((uint32_t)(juce::uint8)id[1] << 16)
+             | ((uint32_t)(juce::uint8)id[2] << 8) | (uint32_t)(juce::uint8)id[3];
+    }
+
+    bool isNoteOn(const MappedMidiFile::Event& e)
+    {
+        return MappedMidiFile::isPacked(e) && (e.data & 0xf0) == 0x90 && ((e.data >> 16) & 0xff) != 0;
+    }
+
+    // Velocity 0 note-ons count as note-offs, as in MidiMessage::isNoteOff()
+    bool isNoteOff(const MappedMidiFile::Event& e)
+    {
+        return MappedMidiFile::isPacked(e)
+            && ((e.data & 0xf0) == 0x80 || ((e.data & 0xf0) == 0x90 && ((e.data >> 16) & 0xff) == 0));
+    }
+}
+
+juce::Result MappedMidiFile::open(const juce::File& file)
+{
+    auto res = map(file);
+    return res.failed() ? res : parseMapped();
+}
+
+juce::Result MappedMidiFile::map(const juce::File& file)
+{
+    close();
+
+    if (file.getSize() >= (juce::int64)kSysexFlag)
+        return juce::Result::fail("MIDI file is too large.");
+
+    mapping = std::make_unique<juce::MemoryMappedFile>(file, juce::MemoryMappedFile::readOnly);
+    if (mapping->getData() == nullptr && file.getSize() > 0) {
+        close();
+        return juce::Result::fail("Could not open file stream.");
+    }
+
+    mappedData = static_cast<const juce::uint8*>(mapping->getData());
+    mappedSize = mapping->getSize();
+    return juce::Result::ok();
+}
+
+juce::Result MappedMidiFile::parseMapped()
+{
+    tracks.clear();
+    trackEventCounts.clear();
+
+    if (mappedData == nullptr || !parse(mappedData, mappedSize)) {
+        close();
+        return juce::Result::fail("Corrupt or invalid MIDI file.");
+    }
+
+    for (auto& t : tracks) trackEventCounts.push_back((int)t.size());
+    return juce::Result::ok();
+}
+
+void MappedMidiFile::restoreTrackInfo(int newTimeFormat, int newFileType, std::vector<int> eventCounts)
+{
+    tracks.clear();
+    timeFormat = newTimeFormat;
+    fileType = newFileType;
+    trackEventCounts = std::move(eventCounts);
+}
+
+void MappedMidiFile::close()
+{
+    tracks.clear();
+    trackEventCounts.clear();
+    mappedData = nullptr;
+    mappedSize = 0;
+    mapping.reset();
+    timeFormat = 0;
+    fileType = 1;
+}
+
+void MappedMidiFile::releaseEvents()
+{
+    std::vector<std::vector<Event>>().swap(tracks);
+}
+
+bool MappedMidiFile::isTempoEvent(const Event& e) const
+{
+    if (isPacked(e) || isSysex(e) || e.size < 6) return false;
+
+    const auto* d = mappedData + e.data;
+    return d[0] == 0xff && d[1] == 0x51 && d[2] == 3;
+}
+
+double MappedMidiFile::getTempoSecondsPerQuarterNote(const Event& e) const
+{
+    if (!isTempoEvent(e)) return 0.0;
+
+    const auto* d = mappedData + e.data + 3;
+    return (((unsigned int)d[0] << 16) | ((unsigned int)d[1] << 8) | d[2]) / 1000000.0;
+}
+
+bool MappedMidiFile::parse(const juce::uint8* data, size_t size)
+{
+    // Header, as MidiFileHelpers::parseMidiHeader: a RIFF (RMID) wrapper is skipped by
+    // scanning a few words ahead for MThd
+    uint32_t word = 0;
+    if (!readBigEndian(data, size, 4, word)) return false;
+
+    if (word != fourCC("MThd")) {
+        bool found = false;
+        if (word == fourCC("RIFF")) {
+            for (int i = 0; i < 8 && !found; ++i) {
+                if (!readBigEndian(data, size, 4, word)) return false;
+                found = (word == fourCC("MThd"));
+            }
+        }
+        if (!found) return false;
+    }
+
+    uint32_t headerLength = 0, type = 0, numTracks = 0, format = 0;
+    if (!readBigEndian(data, size, 4, headerLength) || headerLength < 6 || headerLength > size) return false;
+    if (!readBigEndian(data, size, 2, type) || type > 2) return false;
+    if (!readBigEndian(data, size, 2, numTracks) || (type == 0 && numTracks != 1)) return false;
+    if (!readBigEndian(data, size, 2, format)) return false;
+
+    // Header fields beyond the standard six bytes (later revisions may add some) are skipped
+    data += headerLength - 6;
+    size -= headerLength - 6;
+
+    fileType = (int)type;
+    timeFormat = (int)(juce::int16)format;
+
+    // Every chunk counts against the track total, but only MTrk chunks produce a track
+    for (uint32_t i = 0; i < numTracks; ++i) {
+        uint32_t chunkType = 0, chunkSize = 0;
+        if (!readBigEndian(data, size, 4, chunkType) || !readBigEndian(data, size, 4, chunkSize)) return false;
+        if (size < chunkSize) return false;
+
+        if (chunkType == fourCC("MTrk")) {
+            tracks.emplace_back();
+            readTrack(data, (int)chunkSize, tracks.back());
+            sortNoteOffsFirst(tracks.back());
+            addMatchingNoteOffs(tracks.back());
+        }
+
+        data += chunkSize;
+        size -= chunkSize;
+    }
+
+    // Trailing bytes make the file invalid
+    return size == 0;
+}
+
+void MappedMidiFile::readTrack(const juce::uint8* data, int size, std::vector<Event>& events) const
+{
+    double time = 0.0;
+    juce::uint8 lastStatus = 0;
+
+    while (size > 0) {
+        auto delay = readVariableLength(data, size);
+        if (delay.bytesUsed == 0) break;
+
+        data += delay.bytesUsed;
+        size -= delay.bytesUsed;
+        time += delay.value;
+
+        if (size <= 0) break;
+
+        Event e{ time, 0, 0 };
+        int used = readMessage(data, size, lastStatus, e);
+        if (used <= 0) break;
+
+        data += used;
+        size -= used;
+        events.push_back(e);
+
+        auto first = getFirstByte(e);
+        if ((first & 0xf0) != 0xf0) lastStatus = first;
+    }
+}
+
+int MappedMidiFile::readMessage(const juce::uint8* src, int size, juce::uint8 lastStatus, Event& e) const
+{
+    // Mirrors the MidiMessage(data, size, bytesUsed, lastStatus, time) constructor byte for byte,
+    // but keeps meta events and sysex bodies in the mapping instead of copying them
+    unsigned int status = *src;
+    int used = 0;
+
+    if (status < 0x80) {
+        status = lastStatus; // Running status
+        used = -1;
+    }
+    else {
+        --size;
+        ++src;
+    }
+
+    if (status < 0x80) return 0;
+
+    if (status == 0xf0) {
+        // Skip the embedded length, then take everything up to and including the F7
+        // (or up to the next status byte)
+        const auto* d = src;
+        bool haveReadAllLengthBytes = false;
+        int numLengthBytes = 0;
+
+        while (d < src + size) {
+            if (*d >= 0x80) {
+                if (*d == 0xf7) { ++d; break; }
+                if (haveReadAllLengthBytes) break;
+                ++numLengthBytes;
+            }
+            else if (!haveReadAllLengthBytes) {
+                haveReadAllLengthBytes = true;
+                ++numLengthBytes;
+            }
+            ++d;
+        }
+
+        src += numLengthBytes;
+        int bodySize = (int)(d - src);
+
+        e.data = (uint32_t)(src - mappedData);
+        e.size = (uint32_t)(bodySize + 1) | kSysexFlag;
+        return used + 1 + numLengthBytes + bodySize;
+    }
+
+    if (status == 0xff) {
+        auto length = readVariableLength(src + 1, size - 1);
+        int messageSize = std::min(size + 1, length.bytesUsed + 2 + length.value);
+
+        // FF, type, length and data are contiguous in the file
+        e.data = (uint32_t)(src - 1 - mappedData);
+        e.size = (uint32_t)messageSize;
+
+        // Meta messages up to 3 bytes are packed like any other short message
+        if (e.size <= kMaxPackedSize) {
+            uint32_t packed = 0;
+            for (int b = 0; b < messageSize; ++b) packed |= (uint32_t)src[b - 1] << (8 * b);
+            e.data = packed;
+        }
+        return used + messageSize;
+    }
+
+    int messageSize = shortMessageLength((juce::uint8)status);
+    uint32_t packed = status;
+    if (messageSize > 1) packed |= (uint32_t)(size > 0 ? src[0] : 0) << 8;
+    if (messageSize > 2) packed |= (uint32_t)(size > 1 ? src[1] : 0) << 16;
+
+    e.data = packed;
+    e.size = (uint32_t)messageSize;
+    return used + std::min(messageSize, size + 1);
+}
+
+void MappedMidiFile::sortNoteOffsFirst(std::vector<Event>& events)
+{
+    // MidiFile::readNextTrack stable-sorts with "earlier time, or note-off before note-on at
+    // the same time". Times from the file never decrease, so only runs of equal time change,
+    // and there that comparator moves a note-off back over the note-ons directly before it.
+    for (size_t i = 1; i < events.size(); ++i) {
+        if (!isNoteOff(events[i])) continue;
+
+        size_t j = i;
+        while (j > 0 && events[j - 1].time == events[i].time && isNoteOn(events[j - 1])) --j;
+
+        if (j != i) std::rotate(events.begin() + (std::ptrdiff_t)j, events.begin() + (std::ptrdiff_t)i,
+                                events.begin() + (std::ptrdiff_t)i + 1);
+    }
+}
+
+void MappedMidiFile::addMatchingNoteOffs(std::vector<Event>& events)
+{
+    // MidiMessageSequence::updateMatchedPairs: a note-on followed by another note-on of the same
+    // channel and note, with no note-off in between, gets a note-off inserted just before the
+    // second one. Tracked per channel/note in one pass instead of a forward scan per note-on.
+    std::vector<bool> open(16 * 256, false);
+    std::vector<Event> result;
+    bool inserted = false;
+
+    for (size_t i = 0; i < events.size(); ++i) {
+        const auto& e = events[i];
+        bool on = isNoteOn(e);
+
+        if (on || isNoteOff(e)) {
+            size_t key = (size_t)(e.data & 0x0f) * 256 + ((e.data >> 8) & 0xff);
+
+            if (open[key] && on) {
+                if (!inserted) {
+                    result.reserve(events.size() + events.size() / 16);
+                    result.assign(events.begin(), events.begin() + (std::ptrdiff_t)i);
+                    inserted = true;
+                }
+                // MidiMessage::noteOff(channel, note): velocity 0
+                result.push_back({ e.time, 0x80u | (e.data & 0x0f) | (e.data & 0xff00), 3 });
+            }
+            open[key] = on;
+        }
+
+        if (inserted) result.push_back(e);
+    }
+
+    if (inserted) events.swap(result);
+}
@@ -0,0 +1,87 @@
+/*
+  ==============================================================================
+    MappedMidiFile.h
+
+    Standard MIDI File reader that parses the file in place.
+    The file is memory-mapped rather than read into a heap block, and events
+    are kept as small records: short messages packed into a word, meta events
+    as offsets into the mapping. Produces the same tracks as
+    juce::MidiFile::readFrom(stream, true) (same header/RIFF handling, running
+    status, note-off ordering and matched note-offs), without the 200 MB cap
+    and without one heap MidiMessage per event.
+  ==============================================================================
+*/
+#pragma once
+#include <JuceHeader.h>
+#include <vector>
+
+class MappedMidiFile
+{
+public:
+    struct Event {
+        double time;    // Ticks
+        uint32_t data;  // Packed bytes (b0 | b1 << 8 | b2 << 16), or offset into the mapping
+        uint32_t size;  // Message size in bytes; kSysexFlag when the F0 is not part of the mapped bytes
+    };
+
+    static const uint32_t kMaxPackedSize = 3;
+    static const uint32_t kSysexFlag = 0x80000000u;
+
+    // open() = map() + parseMapped(). A model restored from a cache only needs the mapping,
+    // plus the track details it saved (restoreTrackInfo).
+    juce::Result open(const juce::File& file);
+    juce::Result map(const juce::File& file);
+    juce::Result parseMapped();
+    void restoreTrackInfo(int timeFormat, int fileType, std::vector<int> eventCounts);
+    void close();
+
+    int getNumTracks() const { return (int)trackEventCounts.size(); }
+    int getTimeFormat() const { return timeFormat; }
+    int getFileType() const { return fileType; }
+
+    // Track events stay available until releaseEvents(); the counts and mapping stay after it
+    const std::vector<Event>& getTrack(int track) const { return tracks[(size_t)track]; }
+    int getNumEvents(int track) const { return trackEventCounts[(size_t)track]; }
+    void releaseEvents();
+
+    // Mapped file bytes; valid until close() or the next open()
+    const juce::uint8* getMappedData() const { return mappedData; }
+    size_t getMappedSize() const { return mappedSize; }
+
+    static bool isPacked(const Event& e) { return e.size <= kMaxPackedSize; }
+    static bool isSysex(const Event& e) { return (e.size & kSysexFlag) != 0; }
+
+    juce::uint8 getFirstByte(const Event& e) const {
+        if (isSysex(e)) return 0xf0;
+        return isPacked(e) ? (juce::uint8)(e.data & 0xff) : mappedData[e.data];
+    }
+
+    // Meta event type, or -1 (MidiMessage::getMetaEventType)
+    int getMetaEventType(const Event& e) const {
+        if (isSysex(e) || e.size < 2) return -1;
+        if (isPacked(e)) return (e.data & 0xff) == 0xff ? (int)((e.data >> 8) & 0xff) : -1;
+        return mappedData[e.data] == 0xff ? mappedData[e.data + 1] : -1;
+    }
+
+    bool isEndOfTrack(const Event& e) const { return getMetaEventType(e) == 0x2f; }
+
+    bool isTempoEvent(const Event& e) const;
+    double getTempoSecondsPerQuarterNote(const Event& e) const;
+
+private:
+    bool parse(const juce::uint8* data, size_t size);
+    void readTrack(const juce::uint8* data, int size, std::vector<Event>& events) const;
+    int readMessage(const juce::uint8* src, int size, juce::uint8 lastStatus, Event& e) const;
+
+    static void sortNoteOffsFirst(std::vector<Event>& events);
+    static void addMatchingNoteOffs(std::vector<Event>& events);
+
+    std::unique_ptr<juce::MemoryMappedFile> mapping;
+    const juce::uint8* mappedData = nullptr;
+    size_t mappedSize = 0;
+
+    int timeFormat = 0;
+    int fileType = 1;
+    std::vector<std::vector<Event>> tracks;
+    std::vector<int> trackEventCounts;
+};
@@ -7,83 +7,146 @@
 
 void MidiGridModel::clear()
 {
-    sourceMidi.clear();
+    source.close();
     segmentDeltas.clear();
     timePoints.clear();
-    eventSegments.clear();
+    events.clear();
     totalDurationTicks = 0.0;
     initialBpm = 120.0;
+    tempoMap.reset(960);
     hasLoaded = false;
     midiFormat = 1;
+    solverContext.build({}, 0.0, tempoMap);
+    shape = Shape();
 }
 
-juce::Result MidiGridModel::load(const juce::File& file)
+juce::Result MidiGridModel::load(const juce::File& file, const ModelCache* cache)
 {
     clear();
 
     if (!file.existsAsFile())
         return juce::Result::fail("File not found: " + file.getFullPathName());
 
-    juce::FileInputStream inputStream(file);
-    if (!inputStream.openedOk())
-        return juce::Result::fail("Could not open file stream.");
+    // Parsed in place from a mapping of the file: no stream copy, no MidiMessage per event
+    auto res = source.map(file);
+    if (res.failed()) return res;
 
-    if (!sourceMidi.readFrom(inputStream, true, &midiFormat))
-        return juce::Result::fail("Corrupt or invalid MIDI file.");
+    juce::uint64 contentHash = 0;
+    juce::int64 modificationTime = 0;
 
-    if (sourceMidi.getNumTracks() == 0)
+    if (cache != nullptr) {
+        contentHash = ModelCache::hashContent(source.getMappedData(), source.getMappedSize());
+        modificationTime = file.getLastModificationTime().toMilliseconds();
+
+        if (cache->restore(*this, contentHash, modificationTime)) {
+            hasLoaded = true;
+            solverContext.build(segmentDeltas, totalDurationTicks, tempoMap);
+            analyzeShape();
+            return juce::Result::ok();
+        }
+    }
+
+    res = source.parseMapped();
+    if (res.failed()) return res;
+    midiFormat = source.getFileType();
+
+    if (source.getNumTracks() == 0) {
+        source.close();
         return juce::Result::fail("MIDI file contains no tracks.");
+    }
 
     hasLoaded = true;
-    analyzeTimeline();
-    segmentEvents();
+    {
+        PerfStats::ScopedTimer timer(stats, PerfStats::Stage::AnalyzeTimeline);
+        analyzeTimeline();
+        timer.addCount((int64_t)timePoints.size());
+    }
+    {
+        PerfStats::ScopedTimer timer(stats, PerfStats::Stage::SegmentEvents);
+        segmentEvents();
+        timer.addCount(events.getNumEvents());
+    }
+
+    // Only the table is needed from here on (it still references the mapping)
+    source.releaseEvents();
+
+    solverContext.build(segmentDeltas, totalDurationTicks, tempoMap);
+    analyzeShape();
+
+    // Best effort: a failed write only costs the next load its shortcut
+    if (cache != nullptr) cache->store(*this, contentHash, modificationTime);
 
     return juce::Result::ok();
 }
 
 void MidiGridModel::analyzeTimeline()
 {
-    // Flatten tracks to find all unique rhythmic points
-    juce::MidiMessageSequence merged;
-    for (int i = 0; i < sourceMidi.getNumTracks(); ++i)
-        merged.addSequence(*sourceMidi.getTrack(i), 0.0);
-
-    // Remove EndOfTrack meta events (0x2F) to prevent fake grid points at the end
-    for (int i = merged.getNumEvents() - 1; i >= 0; --i) {
-        auto m = merged.getEventPointer(i)->message;
-        if (m.isMetaEvent() && m.getMetaEventType() == 0x2f)
-            merged.deleteEvent(i, false);
-    }
+    // Every track is already time-ordered (MappedMidiFile sorts them), so k-way merge
+    // the track timestamps straight into the grid instead of building a merged sequence.
+    // Ties keep track order, which matches what a stable merged sort would give.
+    struct Cursor { double time; int track; int index; };
+    auto later = [](const Cursor& a, const Cursor& b) {
+        return a.time > b.time || (a.time == b.time && a.track > b.track);
+    };
 
-    // Sort is critical for delta calculation
-    merged.sort();
-    merged.updateMatchedPairs();
+    std::vector<Cursor> heap;
+    heap.reserve((size_t)source.getNumTracks());
+    size_t totalEvents = 0;
 
-    // 1. Detect BPM 
-    // Uses the first tempo change found. 
-    // TODO: Support complex tempo maps if we add multi-tempo file support.
-    initialBpm = 120.0;
-    for (int i = 0; i < merged.getNumEvents(); ++i) {
-        auto m = merged.getEventPointer(i)->message;
-        if (m.isTempoMetaEvent()) {
-            double spq = m.getTempoSecondsPerQuarterNote();
-            if (spq > 0) initialBpm = 60.0 / spq;
-            break;
+    // Pushes the next event of a track, skipping EndOfTrack meta events (0x2F)
+    // so they don't create fake grid points at the end
+    auto pushNext = [&](int track, int index) {
+        const auto& seq = source.getTrack(track);
+        for (; index < (int)seq.size(); ++index) {
+            const auto& e = seq[(size_t)index];
+            if (source.isEndOfTrack(e)) continue;
+
+            heap.push_back({ e.time, track, index });
+            std::push_heap(heap.begin(), heap.end(), later);
+            return;
         }
+    };
+
+    for (int i = 0; i < source.getNumTracks(); ++i) {
+        totalEvents += (size_t)source.getNumEvents(i);
+        pushNext(i, 0);
     }
 
+    // 1. Collect the tempo map (in the same pass)
+    // Changes arrive in time order; initialBpm keeps the first one for display.
+    initialBpm = 120.0;
+    tempoMap.reset(getPPQ());
+    bool tempoFound = false;
+
     // 2. Build Grid Points
     timePoints.clear();
+    timePoints.reserve(totalEvents + 1);
     timePoints.push_back(0.0);
 
     double lastT = 0.0;
-    for (int i = 0; i < merged.getNumEvents(); ++i) {
-        double t = merged.getEventPointer(i)->message.getTimeStamp();
+    while (!heap.empty()) {
+        std::pop_heap(heap.begin(), heap.end(), later);
+        Cursor c = heap.back();
+        heap.pop_back();
+
+        const auto& e = source.getTrack(c.track)[(size_t)c.index];
+        if (source.isTempoEvent(e)) {
+            double spq = source.getTempoSecondsPerQuarterNote(e);
+            if (spq > 0) {
+                tempoMap.addChange(c.time, std::round(spq * 1000000.0));
+                if (!tempoFound) initialBpm = 60.0 / spq;
+            }
+            tempoFound = true;
+        }
+
+        double t = c.time;
         // Debounce micro-timing (< 0.001 ticks) to avoid zero-length segments
         if (t > lastT + 0.001) {
             timePoints.push_back(t);
             lastT = t;
         }
+
+        pushNext(c.track, c.index + 1);
     }
 
     // 3. Calculate Deltas
@@ -96,6 +159,7 @@ void MidiGridModel::analyzeTimeline()
         totalDurationTicks = 960.0;
     }
     else {
+        segmentDeltas.reserve(timePoints.size() - 1);
         for (size_t i = 0; i < timePoints.size() - 1; ++i) {
             double dt = timePoints[i + 1] - timePoints[i];
             segmentDeltas.push_back(dt);
@@ -104,30 +168,49 @@ void MidiGridModel::analyzeTimeline()
     }
 }
 
+void MidiGridModel::analyzeShape()
+{
+    shape.singleTrack = getNumTracks() == 1;
+    shape.uniformGrid = solverContext.isUniformGrid();
+    shape.trackHasMeta.assign((size_t)getNumTracks(), false);
+
+    for (int i = 0; i < events.getNumEvents(); ++i) {
+        int track = events.getTrackIndex(i);
+        if (track < getNumTracks() && events.isMetaEvent(i)) shape.trackHasMeta[(size_t)track] = true;
+    }
+}
+
 void MidiGridModel::segmentEvents()
 {
-    eventSegments.clear();
-    eventSegments.resize(timePoints.size() + 1);
+    const int numBuckets = (int)timePoints.size() + 1;
 
-    for (int t = 0; t < sourceMidi.getNumTracks(); ++t) {
-        const auto* track = sourceMidi.getTrack(t);
-        for (const auto* ev : *track) {
-            const auto& msg = ev->message;
+    // Pass 1: find the bucket of every event (-1 = skipped) and count bucket sizes
+    std::vector<int> bucketOf;
+    std::vector<uint32_t> bucketCounts((size_t)numBuckets, 0);
 
+    for (int t = 0; t < source.getNumTracks(); ++t) {
+        for (const auto& ev : source.getTrack(t)) {
             // Skip EndOfTrack markers
-            if (msg.isMetaEvent() && msg.getMetaEventType() == 0x2f) continue;
+            if (source.isEndOfTrack(ev)) { bucketOf.push_back(-1); continue; }
 
-            double tStamp = msg.getTimeStamp();
+            double tStamp = ev.time;
 
             // Find nearest segment (Bucket)
+            // timePoints is sorted, so only the grid lines either side of the event
+            // can be closest. Ties go to the earlier line.
             int bestIdx = -1;
             double minDiff = std::numeric_limits<double>::max();
 
-            for (size_t i = 0; i < timePoints.size(); ++i) {
-                double diff = std::abs(tStamp - timePoints[i]);
-                if (diff < minDiff) {
+            auto next = std::lower_bound(timePoints.begin(), timePoints.end(), tStamp);
+            if (next != timePoints.end()) {
+                minDiff = std::abs(tStamp - *next);
+                bestIdx = (int)(next - timePoints.begin());
+            }
+            if (next != timePoints.begin()) {
+                double diff = std::abs(tStamp - *(next - 1));
+                if (diff <= minDiff) {
                     minDiff = diff;
-                    bestIdx = (int)i;
+                    bestIdx = (int)(next - timePoints.begin()) - 1;
                 }
             }
 
@@ -136,14 +219,133 @@ void MidiGridModel::segmentEvents()
                 bestIdx = (int)timePoints.size() - 1;
             }
 
-            if (bestIdx >= 0) {
-                juce::MidiMessage clone = msg;
-                // Store relative offset (Groove) from the grid line
-                double gridTime = timePoints[bestIdx];
-                clone.setTimeStamp(tStamp - gridTime);
+            bucketOf.push_back(bestIdx);
+            if (bestIdx >= 0) ++bucketCounts[(size_t)bestIdx];
+        }
+    }
 
-                eventSegments[bestIdx].push_back({ t, clone });
-            }
+    // Pass 2: scatter into the flat table, in the same order
+    events.allocate(bucketCounts);
+    events.setExternalData(source.getMappedData());
+
+    std::vector<uint32_t> cursor((size_t)numBuckets, 0);
+    for (int b = 0; b < numBuckets; ++b) cursor[(size_t)b] = (uint32_t)events.bucketBegin(b);
+
+    size_t n = 0;
+    for (int t = 0; t < source.getNumTracks(); ++t) {
+        for (const auto& ev : source.getTrack(t)) {
+            int bucket = bucketOf[n++];
+            if (bucket < 0) continue;
+
+            // Store relative offset (Groove) from the grid line
+            double groove = ev.time - timePoints[(size_t)bucket];
+            auto slot = cursor[(size_t)bucket]++;
+
+            if (MappedMidiFile::isSysex(ev))
+                events.setSysexEvent(slot, groove, t, source.getMappedData() + ev.data, (ev.size & ~MappedMidiFile::kSysexFlag) - 1);
+            else if (MappedMidiFile::isPacked(ev))
+                events.setPackedEvent(slot, groove, t, ev.data, ev.size);
+            else
+                events.setExternalEvent(slot, groove, t, ev.data, ev.size);
         }
     }
+}
+
+// --- GridEventTable ---
+
+void GridEventTable::clear()
+{
+    grooveOffsets.clear();
+    trackIndices.clear();
+    payloads.clear();
+    sizes.clear();
+    blobPool.clear();
+    bucketStarts.clear();
+    externalData = nullptr;
+}
+
+void GridEventTable::allocate(const std::vector<uint32_t>& bucketCounts)
+{
+    clear();
+
+    bucketStarts.resize(bucketCounts.size() + 1);
+    bucketStarts[0] = 0;
+    for (size_t b = 0; b < bucketCounts.size(); ++b)
+        bucketStarts[b + 1] = bucketStarts[b] + bucketCounts[b];
+
+    size_t total = bucketStarts.back();
+    grooveOffsets.resize(total);
+    trackIndices.resize(total);
+    payloads.resize(total);
+    sizes.resize(total);
+}
+
+void GridEventTable::setSlot(uint32_t slot, double grooveOffset, int trackIndex, uint32_t payload, uint32_t size)
+{
+    grooveOffsets[slot] = grooveOffset;
+    trackIndices[slot] = (uint16_t)trackIndex;
+    payloads[slot] = payload;
+    sizes[slot] = size;
+}
+
+void GridEventTable::setPackedEvent(uint32_t slot, double grooveOffset, int trackIndex, uint32_t packed, uint32_t size)
+{
+    jassert(size <= kMaxPackedSize);
+    setSlot(slot, grooveOffset, trackIndex, packed, size);
+}
+
+void GridEventTable::setExternalEvent(uint32_t slot, double grooveOffset, int trackIndex, uint32_t offset, uint32_t size)
+{
+    jassert(externalData != nullptr && size > kMaxPackedSize);
+    setSlot(slot, grooveOffset, trackIndex, offset, size | kExternalFlag);
+}
+
+void GridEventTable::setSysexEvent(uint32_t slot, double grooveOffset, int trackIndex, const juce::uint8* body, uint32_t bodySize)
+{
+    // Stored the way MidiMessage holds it: F0 followed by the body, without the file's length bytes.
+    // A sysex that short packs like any other message, since the readers tell packed entries by size
+    if (bodySize + 1 <= kMaxPackedSize) {
+        uint32_t packed = 0xf0;
+        for (uint32_t b = 0; b < bodySize; ++b)
+            packed |= (uint32_t)body[b] << (8 * (b + 1));
+
+        setSlot(slot, grooveOffset, trackIndex, packed, bodySize + 1);
+        return;
+    }
+
+    setSlot(slot, grooveOffset, trackIndex, (uint32_t)blobPool.size(), bodySize + 1);
+    blobPool.push_back(0xf0);
+    blobPool.insert(blobPool.end(), body, body + bodySize);
+}
+
+juce::MidiMessage GridEventTable::createMessage(int i, double timeStamp) const
+{
+    juce::uint8 scratch[kMaxPackedSize];
+    int size = 0;
+    const auto* data = getRawData(i, scratch, size);
+    return juce::MidiMessage(data, size, timeStamp);
+}
+
+const juce::uint8* GridEventTable::getRawData(int i, juce::uint8 (&scratch)[3], int& size) const
+{
+    auto payload = payloads[(size_t)i];
+    size = (int)(sizes[(size_t)i] & ~kExternalFlag);
+
+    if ((uint32_t)size <= kMaxPackedSize) {
+        for (int b = 0; b < size; ++b)
+            scratch[b] = (juce::uint8)(payload >> (8 * b));
+        return scratch;
+    }
+
+    return getBlob(i);
+}
+
+void GridEventTable::getTrackRange(int bucket, int track, int& begin, int& end) const
+{
+    auto first = trackIndices.begin() + bucketBegin(bucket);
+    auto last = trackIndices.begin() + bucketEnd(bucket);
+    auto range = std::equal_range(first, last, (uint16_t)track);
+
+    begin = (int)(range.first - trackIndices.begin());
+    end = (int)(range.second - trackIndices.begin());
 }
\ No newline at end of file
@@ -9,10 +9,74 @@
 #pragma once
 #include <JuceHeader.h>
 #include <vector>
+#include "GeometricTimeSolver.h"
+#include "TempoMap.h"
+#include "MappedMidiFile.h"
+#include "ModelCache.h"
 
-struct QueuedEvent {
-    int sourceTrackIndex;
-    juce::MidiMessage message; // Timestamp is relative to segment start
+/**
+ * Flat, struct-of-arrays store of the bucketed source events.
+ * Event i belongs to bucket b when bucketBegin(b) <= i < bucketEnd(b); inside a bucket
+ * events keep source order (track by track). Messages of up to 3 bytes are packed
+ * into a single word. Longer meta events are referenced in place in the source file
+ * mapping (setExternalData); longer sysex, whose file form embeds a length, is copied to a pool.
+ */
+class GridEventTable
+{
+public:
+    void clear();
+
+    // Building: size the table from per-bucket event counts, then fill every slot once
+    void allocate(const std::vector<uint32_t>& bucketCounts);
+    void setExternalData(const juce::uint8* data) { externalData = data; }
+
+    void setPackedEvent(uint32_t slot, double grooveOffset, int trackIndex, uint32_t packed, uint32_t size);
+    void setExternalEvent(uint32_t slot, double grooveOffset, int trackIndex, uint32_t offset, uint32_t size);
+    void setSysexEvent(uint32_t slot, double grooveOffset, int trackIndex, const juce::uint8* body, uint32_t bodySize);
+
+    int getNumBuckets() const { return bucketStarts.empty() ? 0 : (int)bucketStarts.size() - 1; }
+    int getNumEvents() const { return (int)grooveOffsets.size(); }
+    int bucketBegin(int bucket) const { return (int)bucketStarts[(size_t)bucket]; }
+    int bucketEnd(int bucket) const { return (int)bucketStarts[(size_t)bucket + 1]; }
+    int getBucketSize(int bucket) const { return bucketEnd(bucket) - bucketBegin(bucket); }
+
+    double getGrooveOffset(int i) const { return grooveOffsets[(size_t)i]; } // Relative to the bucket's grid line
+    int getTrackIndex(int i) const { return trackIndices[(size_t)i]; }
+    bool isMetaEvent(int i) const { return getFirstByte(i) == 0xff; }
+
+    juce::MidiMessage createMessage(int i, double timeStamp) const;
+
+    // Raw bytes of event i without building a MidiMessage (packed messages unpack into 'scratch')
+    const juce::uint8* getRawData(int i, juce::uint8 (&scratch)[3], int& size) const;
+
+    // Inside a bucket events are grouped by ascending track, so one track's slice is contiguous
+    void getTrackRange(int bucket, int track, int& begin, int& end) const;
+
+private:
+    friend class ModelCache;
+
+    static const uint32_t kMaxPackedSize = 3;
+    static const uint32_t kExternalFlag = 0x80000000u; // In 'sizes': payload is an offset into externalData
+
+    const juce::uint8* getBlob(int i) const {
+        auto size = sizes[(size_t)i];
+        return ((size & kExternalFlag) ? externalData : blobPool.data()) + payloads[(size_t)i];
+    }
+
+    juce::uint8 getFirstByte(int i) const {
+        return sizes[(size_t)i] <= kMaxPackedSize ? (juce::uint8)(payloads[(size_t)i] & 0xff)
+                                                  : getBlob(i)[0];
+    }
+
+    void setSlot(uint32_t slot, double grooveOffset, int trackIndex, uint32_t payload, uint32_t size);
+
+    std::vector<double>   grooveOffsets;
+    std::vector<uint16_t> trackIndices;
+    std::vector<uint32_t> payloads;     // Packed bytes (b0 | b1 << 8 | b2 << 16) or offset into blobPool / externalData
+    std::vector<uint32_t> sizes;        // Message size in bytes (plus kExternalFlag)
+    std::vector<juce::uint8> blobPool;
+    const juce::uint8* externalData = nullptr; // Owned by the model, outlives the table contents
+    std::vector<uint32_t> bucketStarts; // numBuckets + 1 offsets
 };
 
 class MidiGridModel
@@ -21,28 +85,55 @@ public:
     MidiGridModel() = default;
 
     void clear();
-    juce::Result load(const juce::File& file);
+
+    // With a cache, a source analysed before (same content and modification time) is
+    // restored from its entry instead of being parsed again, and new analyses are stored
+    juce::Result load(const juce::File& file, const ModelCache* cache = nullptr);
+
+    // Times the analysis stages and the solver phases into 'stats' (nullptr = off).
+    // Must outlive the model, or be reset first.
+    void setStats(PerfStats* s) { stats = s; solverContext.setStats(s); }
+
+    // Thread budget of the solver's drift verification (0 = one per core)
+    void setSolverThreads(int numThreads) { solverContext.setMaxThreads(numThreads); }
 
     // Accessors
     bool isLoaded() const { return hasLoaded; }
-    int getNumTracks() const { return sourceMidi.getNumTracks(); }
-    int getPPQ() const { return sourceMidi.getTimeFormat(); }
-    double getBPM() const { return initialBpm; }
+    int getNumTracks() const { return source.getNumTracks(); }
+    int getPPQ() const { return source.getTimeFormat(); }
+    double getBPM() const { return initialBpm; } // First tempo in the file
+    const TempoMap& getTempoMap() const { return tempoMap; }
     double getTotalDuration() const { return totalDurationTicks; }
 
     const std::vector<double>& getDeltas() const { return segmentDeltas; }
-    const std::vector<std::vector<QueuedEvent>>& getSegments() const { return eventSegments; }
+    const GridEventTable& getEvents() const { return events; }
+
+    // Precomputed solver data for this model (rebuilt on every load)
+    const GeoTimeMath::SolverContext& getSolverContext() const { return solverContext; }
 
-    const juce::MidiFile& getSourceMidi() const { return sourceMidi; }
+    // Source properties the engine picks its specialised generation kernels by (set on every load)
+    struct Shape {
+        bool singleTrack = false;        // Every bucket is one track's slice
+        bool uniformGrid = false;        // All segment deltas are equal
+        std::vector<bool> trackHasMeta;  // Per track: holds meta events (window needs the meta tie-break)
+    };
+    const Shape& getShape() const { return shape; }
+
+    // Events per source track, as juce::MidiFile would hold them (EndOfTrack included)
+    int getSourceEventCount(int track) const { return source.getNumEvents(track); }
 
 private:
+    friend class ModelCache;
+
     void analyzeTimeline();
     void segmentEvents();
+    void analyzeShape();
 
     bool hasLoaded = false;
-    juce::MidiFile sourceMidi;
+    MappedMidiFile source; // Kept mapped while loaded: long meta events point into it
     int midiFormat = 1;
     double initialBpm = 120.0;
+    TempoMap tempoMap;
     double totalDurationTicks = 0.0;
 
     // The calculated grid
@@ -50,5 +141,9 @@ private:
     std::vector<double> segmentDeltas;  // Duration of each segment
 
     // Events bucketed by segment index
-    std::vector<std::vector<QueuedEvent>> eventSegments;
+    GridEventTable events;
+
+    GeoTimeMath::SolverContext solverContext;
+    Shape shape;
+    PerfStats* stats = nullptr;
 };
\ No newline at end of file
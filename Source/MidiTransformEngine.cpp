@@ -4,161 +4,804 @@
   ==============================================================================
 */
 #include "MidiTransformEngine.h"
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
 
 juce::Result MidiTransformEngine::loadSource(const juce::File& file) {
     isGenerated = false;
-    return model.load(file);
+    discardOutput(); // Event indices refer to the old model
+    outputTracks.clear();
+    stepTable.clear();
+    stepTimes.clear();
+    stats.clear();
+
+    PerfStats::ScopedTimer timer(getActiveStats(), PerfStats::Stage::Load);
+    auto res = model.load(file, modelCache);
+    timer.addCount(model.getEvents().getNumEvents());
+    return res;
+}
+
+void MidiTransformEngine::setStatsEnabled(bool shouldBeEnabled)
+{
+    statsEnabled = shouldBeEnabled;
+    model.setStats(getActiveStats());
 }
 
 GeoTimeMath::CalculationResult MidiTransformEngine::runSolver(GeoTimeMath::Mode mode,
-    double reps, double beatRatio, double totalScale, double beatEnd, bool constrainToIntegerReps)
+    double reps, double beatRatio, double totalScale, double beatEnd, bool constrainToIntegerReps,
+    double autoTuneTolerance)
 {
-    int ppq = model.getPPQ() > 0 ? model.getPPQ() : 960;
+    if (autoTuneTolerance > 0.0)
+        return GeoTimeMath::autoTune(
+            model.getSolverContext(), mode, reps, beatRatio, totalScale, beatEnd,
+            constrainToIntegerReps, autoTuneTolerance
+        );
 
+    // Results are cached in the model's context, keyed on the inputs the mode reads, so solving
+    // the same request again (e.g. after its results were written back into the UI) is free
     return GeoTimeMath::solve(
-        mode, reps, beatRatio, totalScale, beatEnd,
-        model.getDeltas(), model.getTotalDuration(),
-        model.getBPM(), ppq, constrainToIntegerReps
+        model.getSolverContext(), mode, reps, beatRatio, totalScale, beatEnd,
+        constrainToIntegerReps
     );
 }
 
-juce::Result MidiTransformEngine::generateOutput(int totalSteps, double s_step)
+// Steps between two progress callbacks
+static constexpr int kProgressInterval = 4096;
+
+// Turns one track's event times, in window order, into output ticks; every output path
+// (generateOutput, the streamed export, renderWindow) rounds through this. The window emits
+// times in order, but two times within rounding of each other (the meta tie-break) can still
+// round out of order, so each tick is held at its predecessor to keep the track non-decreasing.
+// A tick is thus the rounded latest time so far, which only the events less than a tick
+// before it can change.
+struct TickRounder
+{
+    juce::int64 lastTick = 0;
+
+    juce::int64 operator()(double time)
+    {
+        lastTick = std::max(lastTick, (juce::int64)std::llround(time));
+        return lastTick;
+    }
+};
+
+// Drives the step loop shared by every generator, from the cursor's step up to (not including)
+// lastStep of an output of totalSteps steps. The cursor is a StepTimeTable::Cursor (computes
+// each step) or a StepTimeArray::Cursor (reads precomputed steps); the times are the same.
+// Calls addBucket(bucketIdx, placement, baseTime, stepScale) for every bucket placed in the
+// output, in production order (placement k + 1 after step k, 0 at the start, as in
+// StepTimeArray), and stepDone(stepStartTime) after each step. Stores the end time of the last
+// step walked in 'endTime'; returns false if cancelled.
+template <typename StepCursor, typename AddBucketFn, typename StepDoneFn>
+static bool walkSteps(const MidiGridModel& model, StepCursor cursor, int lastStep, int totalSteps,
+    const std::function<bool(double)>& progress, double& endTime,
+    AddBucketFn&& addBucket, StepDoneFn&& stepDone)
+{
+    int segmentCount = (int)model.getDeltas().size();
+    int numBuckets = model.getEvents().getNumBuckets();
+
+    // Events from the very start (Time 0)
+    if (cursor.getStep() == 0 && numBuckets > 0) addBucket(0, 0, 0.0, 1.0);
+
+    for (; cursor.getStep() < lastStep; cursor.advance()) {
+        int k = cursor.getStep();
+
+        // s^k, computed once per step for the delta and every groove offset
+        double stepScale = cursor.getScale();
+
+        // Stretch the duration of this specific segment
+        double stepStartTime = cursor.getStartTime();
+        double stepEndTime = cursor.getEndTime();
+
+        int nextBucketIdx = cursor.getSegment() + 1;
+
+        // Handle loop wrap-around logic
+        if (nextBucketIdx == segmentCount) {
+            // End of source pattern -> Map to end of dest pattern
+            if (segmentCount < numBuckets)
+                addBucket(segmentCount, k + 1, stepEndTime, stepScale);
+
+            // Start of next source pattern -> Map to start of next dest pattern
+            if (k < totalSteps - 1)
+                addBucket(0, k + 1, stepEndTime, stepScale);
+        }
+        else if (nextBucketIdx < numBuckets) {
+            addBucket(nextBucketIdx, k + 1, stepEndTime, stepScale);
+        }
+
+        // Events snap to their nearest grid line, so a negative groove offset never reaches
+        // back past the start of the stretched segment before it: nothing produced from
+        // here on can land before this step's start.
+        stepDone(stepStartTime);
+
+        if (progress && (k + 1) % kProgressInterval == 0 && !progress((double)(k + 1) / totalSteps))
+            return false;
+    }
+
+    endTime = cursor.getStartTime();
+    return true;
+}
+
+// One track's events over all steps from 'steps' (a cursor at step 0), through its reorder
+// window into sink(time, eventIndex, placement).
+// Specialised for the common source shapes (MidiGridModel::Shape): with a single track every
+// bucket is the track's whole slice, so the track range lookup goes; a track without meta
+// events skips the per-event meta check and the meta tie-break of the window.
+// Stores the track's end time in 'lastEventTime'; returns false if cancelled.
+template <bool SingleTrack, bool HasMeta, typename StepCursor, typename Sink>
+static bool emitTrackKernel(const MidiGridModel& model, TrackEmitter& emitter, int track, StepCursor steps,
+    int totalSteps, const std::function<bool(double)>& progress, double& lastEventTime, Sink&& sink)
+{
+    const auto& events = model.getEvents();
+
+    // Inject this track's events with geometric time scaling
+    double endTime = 0.0;
+    bool completed = walkSteps(model, steps, totalSteps, totalSteps,
+        progress, endTime,
+        [&](int bucketIdx, int placement, double baseTime, double stepScale) {
+            int begin = 0, end = 0;
+            if constexpr (SingleTrack) { begin = events.bucketBegin(bucketIdx); end = events.bucketEnd(bucketIdx); }
+            else events.getTrackRange(bucketIdx, track, begin, end);
+
+            // Apply scale to the groove offset too so it stays proportional
+            for (int i = begin; i < end; ++i) {
+                double time = baseTime + events.getGrooveOffset(i) * stepScale;
+                if constexpr (HasMeta) emitter.push(time, i, placement, events.isMetaEvent(i));
+                else emitter.push<false>(time, i, placement, false);
+            }
+        },
+        [&](double stepStartTime) { emitter.flushBefore(stepStartTime, sink); });
+
+    if (!completed) return false;
+
+    // Determine track end time
+    lastEventTime = std::max(endTime, emitter.getLastTime());
+    emitter.flushAll(sink);
+    return true;
+}
+
+// Picks the kernel for this model and track
+template <typename StepCursor, typename Sink>
+static bool emitTrack(const MidiGridModel& model, TrackEmitter& emitter, int track, StepCursor steps,
+    int totalSteps, const std::function<bool(double)>& progress, double& lastEventTime, Sink&& sink)
+{
+    const auto& shape = model.getShape();
+    bool hasMeta = shape.trackHasMeta[(size_t)track];
+
+    if (shape.singleTrack)
+        return hasMeta ? emitTrackKernel<true, true>(model, emitter, track, steps, totalSteps, progress, lastEventTime, sink)
+                       : emitTrackKernel<true, false>(model, emitter, track, steps, totalSteps, progress, lastEventTime, sink);
+
+    return hasMeta ? emitTrackKernel<false, true>(model, emitter, track, steps, totalSteps, progress, lastEventTime, sink)
+                   : emitTrackKernel<false, false>(model, emitter, track, steps, totalSteps, progress, lastEventTime, sink);
+}
+
+std::vector<juce::int64> MidiTransformEngine::getBucketPlacementCounts(int totalSteps) const
+{
+    int segmentCount = (int)model.getDeltas().size();
+    int numBuckets = model.getEvents().getNumBuckets();
+    std::vector<juce::int64> counts((size_t)numBuckets, 0);
+    if (numBuckets == 0 || segmentCount == 0 || totalSteps <= 0) return counts;
+
+    // Same rules as walkSteps(): bucket 0 at the start and after every loop but a final one,
+    // bucket b (1..M-1) after every step of segment b - 1, bucket M at the end of every loop
+    juce::int64 fullLoops = totalSteps / segmentCount;
+    int remainder = totalSteps % segmentCount;
+
+    counts[0] = 1 + fullLoops - (remainder == 0 ? 1 : 0);
+    for (int b = 1; b < std::min(segmentCount, numBuckets); ++b)
+        counts[(size_t)b] = fullLoops + (b <= remainder ? 1 : 0);
+    if (segmentCount < numBuckets)
+        counts[(size_t)segmentCount] = fullLoops;
+
+    return counts;
+}
+
+juce::int64 MidiTransformEngine::predictOutputEventCount(int totalSteps) const
+{
+    const auto& events = model.getEvents();
+    auto placements = getBucketPlacementCounts(totalSteps);
+    if (placements.empty() || placements[0] == 0) return 0;
+
+    juce::int64 count = 0;
+    for (int b = 0; b < (int)placements.size(); ++b)
+        count += placements[(size_t)b] * events.getBucketSize(b);
+
+    // Tempo + time signature, and one EndOfTrack per track
+    return count + 2 + model.getNumTracks();
+}
+
+const StepTimeTable& MidiTransformEngine::getStepTimeTable(int totalSteps, double s_step)
+{
+    if (!stepTable.matches(model.getDeltas(), totalSteps, s_step))
+        stepTable.build(model.getDeltas(), totalSteps, s_step);
+    return stepTable;
+}
+
+MidiTransformEngine::SeekPosition MidiTransformEngine::locate(int totalSteps, double s_step, double tick)
+{
+    const auto& table = getStepTimeTable(totalSteps, s_step);
+    const auto& events = model.getEvents();
+    int segmentCount = (int)model.getDeltas().size();
+    int numBuckets = events.getNumBuckets();
+
+    SeekPosition pos;
+    auto cursor = table.findStep(tick);
+    pos.step = cursor.getStep();
+    if (pos.step >= table.getNumSteps()) return pos;
+
+    // Same wrap rule as walkSteps()
+    int nextBucketIdx = cursor.getSegment() + 1;
+    if (nextBucketIdx == segmentCount)
+        pos.bucket = segmentCount < numBuckets ? segmentCount : (pos.step < totalSteps - 1 ? 0 : -1);
+    else if (nextBucketIdx < numBuckets)
+        pos.bucket = nextBucketIdx;
+
+    if (pos.bucket >= 0) pos.eventIndex = events.bucketBegin(pos.bucket);
+    return pos;
+}
+
+juce::Result MidiTransformEngine::renderWindow(int totalSteps, double s_step, double startTick, double endTick,
+    std::vector<juce::MidiMessageSequence>& tracks)
 {
     if (!model.isLoaded()) return juce::Result::fail("No source MIDI loaded.");
+    if (model.getDeltas().empty()) return juce::Result::fail("Model is empty (no time segments).");
 
-    generatedMidi.clear();
-    int ppq = model.getPPQ() > 0 ? model.getPPQ() : 960;
-    generatedMidi.setTicksPerQuarterNote(ppq);
+    const auto& table = getStepTimeTable(totalSteps, s_step);
+    const auto& events = model.getEvents();
+    int numTracks = model.getNumTracks();
+
+    tracks.assign((size_t)numTracks, juce::MidiMessageSequence());
+
+    // Membership goes by the rounded tick, and a tick depends only on the times less than a tick
+    // before it (TickRounder), so events are collected one tick beyond each edge of the window
+    // and filtered once rounded.
+    double firstTime = startTick - 1.0, lastTime = endTick + 1.0;
+
+    // Buckets placed after step k land between the start of step k and the end of step k + 1,
+    // so the walk starts two steps before the one containing firstTime (one is enough unless an
+    // event sits exactly on the boundary) and stops after the last step starting before lastTime
+    int firstStep = std::max(0, table.findStep(firstTime).getStep() - 2);
+    int lastStep = std::min(table.getNumSteps(), table.findStep(lastTime).getStep() + 1);
+
+    std::vector<TrackEmitter> emitters((size_t)numTracks);
+    std::vector<TickRounder> rounders((size_t)numTracks);
+    auto writeEvent = [&](int track) {
+        return [&, track](double time, int eventIndex, int) {
+            auto tick = rounders[(size_t)track](time);
+            if (tick >= startTick && tick < endTick)
+                tracks[(size_t)track].addEvent(events.createMessage(eventIndex, (double)tick));
+            };
+        };
+
+    double endTime = 0.0;
+    walkSteps(model, table.getStep(firstStep), lastStep, totalSteps, nullptr, endTime,
+        [&](int bucketIdx, int placement, double baseTime, double stepScale) {
+            for (int i = events.bucketBegin(bucketIdx); i < events.bucketEnd(bucketIdx); ++i) {
+                int track = events.getTrackIndex(i);
+                double time = baseTime + events.getGrooveOffset(i) * stepScale;
+                if (track >= numTracks || time < firstTime || time >= lastTime) continue;
+
+                emitters[(size_t)track].push(time, i, placement, events.isMetaEvent(i));
+            }
+        },
+        [&](double stepStartTime) {
+            for (int t = 0; t < numTracks; ++t)
+                emitters[(size_t)t].flushBefore(stepStartTime, writeEvent(t));
+        });
+
+    for (int t = 0; t < numTracks; ++t)
+        emitters[(size_t)t].flushAll(writeEvent(t));
+
+    return juce::Result::ok();
+}
+
+juce::Result MidiTransformEngine::buildOutputCurve(int totalSteps, double s_step, OutputCurve& curve,
+    const ProgressCallback& progress)
+{
+    if (!model.isLoaded()) return juce::Result::fail("No source MIDI loaded.");
+    if (model.getDeltas().empty()) return juce::Result::fail("Model is empty (no time segments).");
+
+    const auto& table = getStepTimeTable(totalSteps, s_step);
+    const auto& events = model.getEvents();
+    curve.reset(table.getEndTime());
+
+    // stepDone() reports each step's start; a step is added once the next one starts
+    double previousStart = 0.0;
+    bool hasPrevious = false;
 
-    const auto& segments = model.getSegments();
-    const auto& deltas = model.getDeltas();
-    int segmentCount = (int)deltas.size();
+    double endTime = 0.0;
+    bool completed = walkSteps(model, StepTimeTable::Cursor(model.getDeltas(), s_step), totalSteps, totalSteps,
+        progress, endTime,
+        [&](int bucketIdx, int, double baseTime, double) {
+            curve.addEvents(baseTime, events.getBucketSize(bucketIdx));
+        },
+        [&](double stepStartTime) {
+            if (hasPrevious) curve.addStep(previousStart, stepStartTime);
+            previousStart = stepStartTime;
+            hasPrevious = true;
+        });
+
+    if (!completed) return juce::Result::fail("Cancelled.");
+
+    if (hasPrevious) curve.addStep(previousStart, endTime);
+    curve.finish();
+    return juce::Result::ok();
+}
+
+// Tempo and time signature at the start of track 0
+static constexpr int kHeaderEvents = 2;
+
+void MidiTransformEngine::discardOutput()
+{
+    // Keeps the storage for the next generation
+    isGenerated = false;
+    keptSteps = 0;
+    for (auto& track : outputTracks) {
+        track.ticks.clear();
+        track.order.clear();
+        track.placements.clear();
+    }
+}
+
+void MidiTransformEngine::truncateOutputTrack(int track, size_t numGenerated)
+{
+    auto& out = outputTracks[(size_t)track];
+    if (out.order.size() > numGenerated) {
+        out.ticks.resize(numGenerated);
+        out.order.resize(numGenerated);
+        out.placements.resize(numGenerated);
+    }
+}
+
+// Time of the event at 'placement' of stepTimes (the arithmetic walkSteps' callers use)
+static double getEventTime(const StepTimeArray& steps, const GridEventTable& events, int eventIndex, int placement)
+{
+    return steps.getBaseTime(placement) + events.getGrooveOffset(eventIndex) * steps.getBaseScale(placement);
+}
+
+// Whether the reorder window puts 'a' before 'b': by time (TrackEmitter::comesBefore), and
+// equal times in production order. Within a placement that is event order, except that the
+// bucket 0 placed at a loop end comes after the last bucket placed there with it.
+template <bool HasMeta>
+static bool staysBefore(const TrackEmitter::Pending& a, const TrackEmitter::Pending& b, int bucket0End, int numEvents)
+{
+    if (TrackEmitter::comesBefore<HasMeta>(b, a)) return false;
+    if (TrackEmitter::comesBefore<HasMeta>(a, b)) return true;
+
+    auto rank = [&](const TrackEmitter::Pending& p) {
+        return p.placement > 0 && p.eventIndex < bucket0End ? p.eventIndex + numEvents : p.eventIndex;
+        };
+    return a.placement != b.placement ? a.placement < b.placement : rank(a) < rank(b);
+}
+
+template <bool HasMeta>
+bool MidiTransformEngine::retimeTrackKernel(int track)
+{
+    auto& out = outputTracks[(size_t)track];
+    const auto& events = model.getEvents();
+    int bucket0End = events.getNumBuckets() > 0 ? events.bucketEnd(0) : 0;
+
+    TrackEmitter::Pending previous{};
+    TickRounder rounder;
+    double lastTime = stepTimes.getEndTime();
+
+    for (size_t pos = 0; pos < out.order.size(); ++pos) {
+        int eventIndex = out.order[pos];
+        int placement = out.placements[pos];
+        TrackEmitter::Pending p{ getEventTime(stepTimes, events, eventIndex, placement), eventIndex, placement,
+                                 HasMeta && events.isMetaEvent(eventIndex) };
+
+        // Checking neighbours is enough: the window's order is a stable sort by time
+        if (pos > 0 && !staysBefore<HasMeta>(previous, p, bucket0End, events.getNumEvents())) return false;
+        previous = p;
+
+        out.ticks[pos] = rounder(p.time);
+        lastTime = std::max(lastTime, p.time);
+    }
+
+    out.endTick = rounder(lastTime);
+    return true;
+}
+
+bool MidiTransformEngine::retimeTrack(int track)
+{
+    return model.getShape().trackHasMeta[(size_t)track] ? retimeTrackKernel<true>(track)
+                                                        : retimeTrackKernel<false>(track);
+}
+
+int MidiTransformEngine::resumeTrack(int track, int resumeStep)
+{
+    auto& out = outputTracks[(size_t)track];
+    auto& emitter = emitters[(size_t)track];
+    const auto& events = model.getEvents();
+
+    // By the start of resumeStep the window had flushed everything before the previous step's
+    // start and held whatever steps up to resumeStep - 1 had produced beyond that. Both only
+    // depend on those steps, which the kept output and this one share.
+    double flushedBefore = stepTimes.getBaseTime(resumeStep - 1) - 1e-6;
+    double latestTime = 0.0;
+
+    size_t flushed = 0;
+    for (; flushed < out.order.size(); ++flushed) {
+        int placement = out.placements[flushed];
+        double time = getEventTime(stepTimes, events, out.order[flushed], placement);
+        if (placement > resumeStep || time >= flushedBefore) break;
+        latestTime = std::max(latestTime, time);
+    }
+
+    emitter.resume(latestTime);
+    for (size_t pos = flushed; pos < out.order.size(); ++pos) {
+        int eventIndex = out.order[pos];
+        int placement = out.placements[pos];
+        if (placement <= resumeStep)
+            emitter.restore({ getEventTime(stepTimes, events, eventIndex, placement), eventIndex, placement,
+                              events.isMetaEvent(eventIndex) });
+    }
+
+    truncateOutputTrack(track, flushed);
+    return (int)flushed;
+}
+
+bool MidiTransformEngine::generateTrack(int track, int totalSteps, Reuse reuse,
+    const std::function<bool(double)>& progress, juce::int64& reused, juce::int64& created)
+{
+    auto& out = outputTracks[(size_t)track];
+    auto& emitter = emitters[(size_t)track];
+
+    // A new s with the same N: every event keeps its position unless the new times reorder
+    // the track, so the ticks are recomputed in one pass without walking the steps
+    if (reuse == Reuse::Retime) {
+        if (retimeTrack(track)) {
+            reused += (juce::int64)out.order.size();
+            return true;
+        }
+        reuse = Reuse::None;
+    }
+
+    // A larger N with the same s: the kept output is cut back to what the window had flushed
+    // before the kept last step (the only step that places differently in a longer output),
+    // and the walk continues from there. Otherwise the track is built from step 0.
+    auto steps = stepTimes.begin();
+    TickRounder rounder;
+
+    if (reuse == Reuse::Extend) {
+        steps = stepTimes.getStep(keptSteps - 1);
+        int kept = resumeTrack(track, keptSteps - 1);
+        if (kept > 0) rounder.lastTick = out.ticks[(size_t)kept - 1];
+        reused += kept;
+    }
+    else {
+        emitter.clear();
+        truncateOutputTrack(track, 0);
+    }
+
+    // Flushed events go straight into the track as integer ticks
+    auto sink = [&](double time, int eventIndex, int placement) {
+        out.ticks.push_back(rounder(time));
+        out.order.push_back(eventIndex);
+        out.placements.push_back(placement);
+        ++created;
+        };
+
+    double lastEventTime = 0.0;
+    if (!emitTrack(model, emitter, track, steps, totalSteps, progress, lastEventTime, sink)) return false;
+
+    // EndOfTrack always goes last, even when other events share its tick
+    out.endTick = rounder(lastEventTime);
+    return true;
+}
+
+juce::Result MidiTransformEngine::generateOutput(int totalSteps, double s_step, const ProgressCallback& progress)
+{
+    if (!model.isLoaded()) return juce::Result::fail("No source MIDI loaded.");
+
+    isGenerated = false;
+    streamedTrackEvents.clear();
+    lastReusedEvents = lastCreatedEvents = 0;
+
+    const auto& events = model.getEvents();
+    int segmentCount = (int)model.getDeltas().size();
 
     if (segmentCount == 0) return juce::Result::fail("Model is empty (no time segments).");
 
-    int numTracks = model.getNumTracks();
-    using TimeEvent = std::pair<double, juce::MidiMessage>;
+    // Huge outputs aren't built in memory at all: saveFile streams them to disk
+    auto predictedEvents = predictOutputEventCount(totalSteps);
+    streamingExport = predictedEvents > kStreamingEventThreshold;
+    pendingSteps = totalSteps;
+    pendingStepScale = s_step;
+
+    if (streamingExport) {
+        outputTracks.clear(); // Nothing is kept in memory for a streamed export
+        keptSteps = 0;
+        isGenerated = true;
+        return juce::Result::ok();
+    }
 
-    // Intermediate storage: Vector of events per track
-    std::vector<std::vector<TimeEvent>> trackStreams(numTracks);
+    int numTracks = model.getNumTracks();
 
-    // 1. Initialize Track 0 with Metadata (Tempo, Time Sig)
-    if (numTracks > 0) {
-        int uspq = (int)(60000000.0 / model.getBPM());
-        trackStreams[0].push_back({ 0.0, juce::MidiMessage::tempoMetaEvent(uspq) });
-        trackStreams[0].push_back({ 0.0, juce::MidiMessage::timeSignatureMetaEvent(4, 4) });
+    // Every kept event records its event index and its placement, which only depend on N and
+    // the model; its time follows from those and the step times of (N, s). So the kept output
+    // is retimed when only s changed, and continued when N grew at the same s (generateTrack).
+    if (outputTracks.size() != (size_t)numTracks) {
+        outputTracks.clear();
+        outputTracks.resize((size_t)numTracks);
+        keptSteps = 0;
     }
 
-    // 2. Add events from the very start (Time 0)
-    if (!segments.empty()) {
-        for (const auto& ev : segments[0]) {
-            if (ev.sourceTrackIndex >= 0 && ev.sourceTrackIndex < numTracks)
-                trackStreams[ev.sourceTrackIndex].push_back({ ev.message.getTimeStamp(), ev.message });
+    Reuse reuse = Reuse::None;
+    if (keptSteps == totalSteps) reuse = Reuse::Retime;
+    else if (keptSteps >= 2 && keptSteps < totalSteps && keptStepScale == s_step) reuse = Reuse::Extend;
+
+    // 1. Size every track for exactly the events it will hold (bucket placements x the track's
+    // share of each bucket), so generation itself never reallocates
+    {
+        auto placements = getBucketPlacementCounts(totalSteps);
+        std::vector<juce::int64> trackCounts((size_t)numTracks, 0);
+
+        for (int b = 0; b < events.getNumBuckets(); ++b)
+            for (int i = events.bucketBegin(b); i < events.bucketEnd(b); ++i)
+                if (events.getTrackIndex(i) < numTracks)
+                    trackCounts[(size_t)events.getTrackIndex(i)] += placements[(size_t)b];
+
+        for (int t = 0; t < numTracks; ++t) {
+            outputTracks[(size_t)t].ticks.reserve((size_t)trackCounts[(size_t)t]);
+            outputTracks[(size_t)t].order.reserve((size_t)trackCounts[(size_t)t]);
+            outputTracks[(size_t)t].placements.reserve((size_t)trackCounts[(size_t)t]);
         }
     }
 
-    // 3. Generate Sequence
-    double currentAbsTime = 0.0;
+    PerfStats::ScopedTimer timer(getActiveStats(), PerfStats::Stage::Generate);
 
-    for (int k = 0; k < totalSteps; ++k) {
-        int segIdx = k % segmentCount;
+    // 2. The step times, computed once here and only read by every track pass below
+    if (!stepTimes.matches(model.getDeltas(), totalSteps, s_step))
+        stepTimes.build(model.getDeltas(), totalSteps, s_step);
 
-        // Stretch the duration of this specific segment
-        double stretchedDelta = deltas[segIdx] * std::pow(s_step, k);
-        currentAbsTime += stretchedDelta;
-
-        int nextBucketIdx = segIdx + 1;
-
-        // Lambda to inject events with geometric time scaling
-        auto addScaledEvents = [&](int bucketIdx, double baseTime) {
-            if (bucketIdx >= (int)segments.size()) return;
-            for (const auto& ev : segments[bucketIdx]) {
-                double grooveOffset = ev.message.getTimeStamp();
-                // Apply scale to the groove offset too so it stays proportional
-                double scaledOffset = grooveOffset * std::pow(s_step, k);
-
-                if (ev.sourceTrackIndex >= 0 && ev.sourceTrackIndex < numTracks) {
-                    trackStreams[ev.sourceTrackIndex].push_back({ baseTime + scaledOffset, ev.message });
-                }
-            }
+    // 3. Generate the tracks. Tracks are independent after bucketing, so each one is its own
+    // pass over the steps, writing only its own output track; large outputs run the passes
+    // on several threads. Either way the result is the same, track by track.
+    emitters.resize((size_t)numTracks);
+    std::vector<juce::int64> reused((size_t)numTracks, 0), created((size_t)numTracks, 0);
+
+    int numThreads = generationThreads > 0 ? generationThreads : (int)std::thread::hardware_concurrency();
+    numThreads = std::min(numThreads, numTracks);
+    if (predictedEvents < kParallelGenerationEvents) numThreads = 1;
+
+    bool completed = true;
+
+    if (numThreads <= 1) {
+        for (int t = 0; t < numTracks && completed; ++t) {
+            // Progress of this pass, scaled into the overall fraction
+            std::function<bool(double)> trackProgress;
+            if (progress)
+                trackProgress = [&](double fraction) { return progress((t + fraction) / numTracks); };
+
+            completed = generateTrack(t, totalSteps, reuse, trackProgress, reused[(size_t)t], created[(size_t)t]);
+        }
+    }
+    else {
+        // Tracks are handed out one at a time; the calling thread only polls 'progress', so the
+        // callback is never entered from two threads at once
+        std::atomic<int> nextTrack{ 0 };
+        std::atomic<juce::int64> stepsDone{ 0 };
+        std::atomic<bool> cancelled{ false };
+        std::mutex doneLock;
+        std::condition_variable doneSignal;
+        int workersLeft = numThreads;
+
+        std::function<bool(double)> workerProgress = [&](double) {
+            stepsDone += kProgressInterval;
+            return !cancelled.load();
             };
 
-        // Handle loop wrap-around logic
-        if (nextBucketIdx == segmentCount) {
-            // End of source pattern -> Map to end of dest pattern
-            if (segmentCount < (int)segments.size())
-                addScaledEvents(segmentCount, currentAbsTime);
+        std::vector<std::thread> workers;
+        workers.reserve((size_t)numThreads);
 
-            // Start of next source pattern -> Map to start of next dest pattern
-            if (k < totalSteps - 1)
-                addScaledEvents(0, currentAbsTime);
+        for (int w = 0; w < numThreads; ++w) {
+            workers.emplace_back([&] {
+                for (int t = nextTrack++; t < numTracks && !cancelled; t = nextTrack++)
+                    if (!generateTrack(t, totalSteps, reuse, workerProgress, reused[(size_t)t], created[(size_t)t]))
+                        cancelled = true;
+
+                std::lock_guard<std::mutex> lock(doneLock);
+                if (--workersLeft == 0) doneSignal.notify_one();
+                });
         }
-        else {
-            addScaledEvents(nextBucketIdx, currentAbsTime);
+
+        double totalWork = (double)totalSteps * numTracks;
+        for (;;) {
+            {
+                std::unique_lock<std::mutex> lock(doneLock);
+                if (doneSignal.wait_for(lock, std::chrono::milliseconds(20), [&] { return workersLeft == 0; }))
+                    break;
+            }
+            if (progress && !progress(std::min(1.0, (double)stepsDone.load() / totalWork)))
+                cancelled = true;
         }
+
+        for (auto& w : workers) w.join();
+        completed = !cancelled;
+    }
+
+    if (!completed) {
+        // Tracks are half patched at this point
+        discardOutput();
+        return juce::Result::fail("Cancelled.");
     }
 
-    // 4. Finalize Tracks
     for (int t = 0; t < numTracks; ++t) {
-        auto& stream = trackStreams[t];
+        lastReusedEvents += reused[(size_t)t];
+        lastCreatedEvents += created[(size_t)t];
+    }
 
-        // Determine track end time
-        double lastEventTime = currentAbsTime;
-        for (const auto& ev : stream) {
-            if (ev.first > lastEventTime) lastEventTime = ev.first;
-        }
-        stream.push_back({ lastEventTime, juce::MidiMessage::endOfTrack() });
-
-        // Stable sort ensures events at same tick (e.g. NoteOn + NoteOff) stay in added order
-        // Secondary sort by message type ensures Meta events processed first
-        std::stable_sort(stream.begin(), stream.end(),
-            [](const TimeEvent& a, const TimeEvent& b) {
-                if (std::abs(a.first - b.first) > 1e-6) return a.first < b.first;
-                return (a.second.isMetaEvent() ? 0 : 1) < (b.second.isMetaEvent() ? 0 : 1);
-            });
-
-        // Convert double timestamps to integer ticks
-        juce::MidiMessageSequence seq;
-        for (const auto& ev : stream) {
-            juce::MidiMessage m = ev.second;
-            m.setTimeStamp((double)std::llround(ev.first));
-            seq.addEvent(m);
-        }
-        seq.updateMatchedPairs();
-        generatedMidi.addTrack(seq);
+    if (statsEnabled) {
+        timer.addCount(lastReusedEvents + lastCreatedEvents);
+        for (const auto& emitter : emitters) stats.addCount(PerfStats::Stage::Sort, emitter.getNumReordered());
     }
 
+    keptSteps = totalSteps;
+    keptStepScale = s_step;
     isGenerated = true;
     return juce::Result::ok();
 }
 
-juce::Result MidiTransformEngine::saveFile(const juce::File& dest) {
+juce::Result MidiTransformEngine::saveFile(const juce::File& dest, const ProgressCallback& progress) {
     if (!isGenerated) return juce::Result::fail("Nothing to save.");
 
     if (dest.existsAsFile() && !dest.deleteFile())
         return juce::Result::fail("File locked.");
 
+    PerfStats::ScopedTimer timer(getActiveStats(), PerfStats::Stage::Write);
+
+    if (streamingExport) {
+        auto res = juce::Result::ok();
+        {
+            juce::FileOutputStream stream(dest);
+            if (!stream.openedOk()) return juce::Result::fail("Write error.");
+            res = writeStreaming(stream, progress);
+        }
+
+        // Don't leave a truncated file behind after a cancel or a failed write
+        if (res.failed()) dest.deleteFile();
+        else for (auto n : streamedTrackEvents) timer.addCount(n);
+        return res;
+    }
+
     juce::FileOutputStream stream(dest);
     if (!stream.openedOk()) return juce::Result::fail("Write error.");
 
+    auto res = writeInMemory(stream);
+    if (res.wasOk())
+        for (size_t t = 0; t < outputTracks.size(); ++t)
+            timer.addCount((juce::int64)outputTracks[t].order.size() + (t == 0 ? kHeaderEvents : 0) + 1);
+    return res;
+}
+
+juce::Result MidiTransformEngine::writeInMemory(juce::FileOutputStream& stream)
+{
+    int numTracks = (int)outputTracks.size();
+    int ppq = model.getPPQ() > 0 ? model.getPPQ() : 960;
+
     // Force Type 1 for multi-track compatibility
-    int format = (generatedMidi.getNumTracks() > 1) ? 1 : 0;
+    StreamingMidiWriter writer(stream);
+    if (!writer.writeHeader(numTracks > 1 ? 1 : 0, numTracks, ppq))
+        return juce::Result::fail("Write error.");
+
+    const auto& events = model.getEvents();
+
+    for (int t = 0; t < numTracks; ++t) {
+        const auto& out = outputTracks[(size_t)t];
+        if (!writer.beginTrack()) return juce::Result::fail("Write error.");
+
+        // These sort ahead of everything else at tick 0 and never change with the parameters
+        if (t == 0 && !(writer.writeEvent(0, juce::MidiMessage::tempoMetaEvent(getTempoMicrosecondsPerQuarter()))
+                        && writer.writeEvent(0, juce::MidiMessage::timeSignatureMetaEvent(4, 4))))
+            return juce::Result::fail("Write error.");
 
-    return generatedMidi.writeTo(stream, format)
-        ? juce::Result::ok()
-        : juce::Result::fail("Write error.");
+        for (size_t i = 0; i < out.order.size(); ++i) {
+            juce::uint8 scratch[3];
+            int size = 0;
+            const auto* data = events.getRawData(out.order[i], scratch, size);
+            if (!writer.writeEvent(out.ticks[i], data, size)) return juce::Result::fail("Write error.");
+        }
+
+        if (!writer.endTrack(out.endTick)) return juce::Result::fail("Write error.");
+    }
+
+    stream.flush();
+    return stream.getStatus();
+}
+
+juce::Result MidiTransformEngine::writeStreaming(juce::FileOutputStream& stream, const ProgressCallback& progress)
+{
+    const auto& events = model.getEvents();
+    int numTracks = model.getNumTracks();
+    int ppq = model.getPPQ() > 0 ? model.getPPQ() : 960;
+
+    StreamingMidiWriter writer(stream);
+    if (!writer.writeHeader(numTracks > 1 ? 1 : 0, numTracks, ppq))
+        return juce::Result::fail("Write error.");
+
+    streamedTrackEvents.assign((size_t)numTracks, 0);
+
+    // SMF track chunks are sequential, so the steps are walked once per track. Each pass only
+    // touches its own track's slice of every bucket and keeps one reorder window in memory.
+    for (int t = 0; t < numTracks; ++t) {
+        if (!writer.beginTrack()) return juce::Result::fail("Write error.");
+
+        if (t == 0 && !(writer.writeEvent(0, juce::MidiMessage::tempoMetaEvent(getTempoMicrosecondsPerQuarter()))
+                        && writer.writeEvent(0, juce::MidiMessage::timeSignatureMetaEvent(4, 4))))
+            return juce::Result::fail("Write error.");
+
+        TrackEmitter emitter;
+        bool ok = true;
+        TickRounder rounder;
+
+        auto sink = [&](double time, int eventIndex, int) {
+            juce::uint8 scratch[3];
+            int size = 0;
+            const auto* data = events.getRawData(eventIndex, scratch, size);
+            ok = writer.writeEvent(rounder(time), data, size) && ok;
+            };
+
+        // Progress of this pass, scaled into the overall fraction
+        std::function<bool(double)> trackProgress;
+        if (progress)
+            trackProgress = [&](double fraction) { return progress((t + fraction) / numTracks); };
+
+        double lastEventTime = 0.0;
+        // N can be far larger here than in memory, so the steps are recomputed per pass rather than held
+        if (!emitTrack(model, emitter, t, StepTimeTable::Cursor(model.getDeltas(), pendingStepScale), pendingSteps,
+                       trackProgress, lastEventTime, sink))
+            return juce::Result::fail("Cancelled.");
+
+        if (statsEnabled) stats.addCount(PerfStats::Stage::Sort, emitter.getNumReordered());
+
+        if (!ok || !writer.endTrack(rounder(lastEventTime)))
+            return juce::Result::fail("Write error.");
+
+        streamedTrackEvents[(size_t)t] = writer.getNumEventsInTrack();
+    }
+
+    stream.flush();
+    return stream.getStatus();
+}
+
+int MidiTransformEngine::getTempoMicrosecondsPerQuarter() const
+{
+    // Later changes are source events and reach the output through their buckets
+    return juce::roundToInt(model.getTempoMap().getMicrosecondsPerQuarterAt(0.0));
 }
 
 juce::String MidiTransformEngine::getDebugDump() {
     juce::String s = "--- DEBUG ---\n";
-    if (model.isLoaded()) s << midiToString(model.getSourceMidi(), "SOURCE");
-    if (isGenerated) s << midiToString(generatedMidi, "OUTPUT");
-    return s;
-}
+    if (model.isLoaded()) {
+        s << "\n[SOURCE]\n";
+        for (int i = 0; i < model.getNumTracks(); ++i)
+            s << "Trk" << i << ": " << model.getSourceEventCount(i) << " evs\n";
+        s << "Tempo map: " << model.getTempoMap().getNumSegments() << " segments\n";
 
-juce::String MidiTransformEngine::midiToString(const juce::MidiFile& file, const juce::String& title) {
-    juce::String s; s << "\n[" << title << "]\n";
-    for (int i = 0; i < file.getNumTracks(); ++i)
-        s << "Trk" << i << ": " << file.getTrack(i)->getNumEvents() << " evs\n";
+        const auto& shape = model.getShape();
+        int metaFree = (int)std::count(shape.trackHasMeta.begin(), shape.trackHasMeta.end(), false);
+        s << "Shape: " << (shape.singleTrack ? "single track" : "multi track")
+          << (shape.uniformGrid ? ", uniform grid" : "") << ", "
+          << metaFree << "/" << (int)shape.trackHasMeta.size() << " tracks without meta events\n";
+    }
+    if (isGenerated && !streamingExport) {
+        s << "\n[OUTPUT]\n";
+        for (size_t i = 0; i < outputTracks.size(); ++i)
+            s << "Trk" << (int)i << ": " << (int)outputTracks[i].order.size() + (i == 0 ? kHeaderEvents : 0) + 1 << " evs\n";
+    }
+    if (isGenerated && streamingExport) {
+        s << "\n[OUTPUT (STREAMED)]\n";
+        for (size_t i = 0; i < streamedTrackEvents.size(); ++i)
+            s << "Trk" << (int)i << ": " << (juce::int64)streamedTrackEvents[i] << " evs\n";
+    }
+    if (statsEnabled) {
+        s << "\n[STATS]\n";
+        s << juce::String(stats.format());
+    }
     return s;
-}
\ No newline at end of file
+}
@@ -11,6 +11,11 @@
 #include <JuceHeader.h>
 #include "MidiGridModel.h"
 #include "GeometricTimeSolver.h"
+#include "TrackEmitter.h"
+#include "StreamingMidiWriter.h"
+#include "StepTimeTable.h"
+#include "OutputCurve.h"
+#include "PerfStats.h"
 
 class MidiTransformEngine
 {
@@ -18,30 +23,161 @@ public:
     MidiTransformEngine() = default;
     ~MidiTransformEngine() = default;
 
+    // Polled by long operations with the fraction done (0..1); returning false aborts them.
+    // The engine is not internally locked: callers running it off the message thread must
+    // not touch it from anywhere else until the operation returns.
+    using ProgressCallback = std::function<bool(double fraction)>;
+
     juce::Result loadSource(const juce::File& file);
 
-    // Run the solver to determine generation parameters
+    // Analysed models are looked up in / added to this cache on load (nullptr = no cache).
+    // The cache must outlive the engine.
+    void setModelCache(const ModelCache* cache) { modelCache = cache; }
+
+    // Run the solver to determine generation parameters.
+    // A positive autoTuneTolerance (relative, 0.02 = 2%) searches nearby for the least drift.
     GeoTimeMath::CalculationResult runSolver(GeoTimeMath::Mode mode,
-        double reps, double s, double R, double endScale, bool constrainToIntegerReps);
+        double reps, double s, double R, double endScale, bool constrainToIntegerReps,
+        double autoTuneTolerance = 0.0);
+
+    // Construct the new MIDI sequence based on solved parameters.
+    // The previous output is kept. With the same N and a new s, each track's ticks are
+    // recomputed in one pass over its events (no step walk, no reordering) unless the new s
+    // changes the track's event order; with a larger N and the same s, each track continues
+    // from the previous last step. Any other change, or a reordered track, is built anew.
+    // Outputs above kStreamingEventThreshold events are not built in memory: only the
+    // parameters are kept, and saveFile streams the SMF straight to disk (bounded memory).
+    juce::Result generateOutput(int steps, double s, const ProgressCallback& progress = nullptr);
+
+    juce::Result saveFile(const juce::File& destination, const ProgressCallback& progress = nullptr);
+
+    // Drops the kept output, so the next generateOutput builds everything from scratch
+    void discardOutput();
+
+    // Threads generateOutput may use, one track per thread (0 = one per core). Outputs below
+    // kParallelGenerationEvents events are always generated on the calling thread.
+    void setGenerationThreads(int numThreads) { generationThreads = numThreads; }
+
+    // Threads runSolver's drift verification may use (0 = one per core)
+    void setSolverThreads(int numThreads) { model.setSolverThreads(numThreads); }
 
-    // Construct the new MIDI sequence based on solved parameters
-    juce::Result generateOutput(int steps, double s);
+    static constexpr juce::int64 kStreamingEventThreshold = 4000000;
+    static constexpr juce::int64 kParallelGenerationEvents = 1 << 16;
 
-    juce::Result saveFile(const juce::File& destination);
+    // Step start times for (steps, s). Built on first use (O(N)) and kept while the model
+    // and the parameters stay the same.
+    const StepTimeTable& getStepTimeTable(int steps, double s);
+
+    struct SeekPosition {
+        int step = 0;        // Step whose stretched segment contains the tick (N past the end)
+        int bucket = -1;     // Bucket placed at the end of that step, -1 if none
+        int eventIndex = 0;  // First event of that bucket in the model's GridEventTable
+    };
+
+    // O(log N) once the table for (steps, s) exists
+    SeekPosition locate(int steps, double s, double tick);
+
+    // Builds only the output events whose rounded ticks are in [startTick, endTick), one
+    // sequence per track, in the same order and with the same ticks generateOutput gives them
+    // (both round through the same tick clamp). Costs a seek plus the steps inside the window.
+    // Track 0's tempo and time signature header is not included.
+    juce::Result renderWindow(int steps, double s, double startTick, double endTick,
+                              std::vector<juce::MidiMessageSequence>& tracks);
+
+    // Fills 'curve' with the overview of the output for (steps, s). O(N); needs only the
+    // solved parameters, so it can run before (or instead of) generating.
+    juce::Result buildOutputCurve(int steps, double s, OutputCurve& curve, const ProgressCallback& progress = nullptr);
+
+    // Exact number of events the output will contain (computable from bucket sizes)
+    juce::int64 predictOutputEventCount(int steps) const;
+    bool isStreamingExport() const { return streamingExport; }
 
     // Diagnostics
     juce::String getDebugDump();
 
+    // Per-stage timers and counters (load, analysis, solver phases, generation, reordering,
+    // write), accumulated from the last loadSource on. Off by default; when off, nothing is
+    // timed or counted.
+    void setStatsEnabled(bool shouldBeEnabled);
+    bool isStatsEnabled() const { return statsEnabled; }
+    const PerfStats& getStats() const { return stats; }
+
     // State inspectors
     bool isSourceLoaded() const { return model.isLoaded(); }
     int getSourceTrackCount() const { return model.getNumTracks(); }
     int getSegmentCount() const { return (int)model.getDeltas().size(); }
     double getSourceBPM() const { return model.getBPM(); }
+    int getSourceTempoSegmentCount() const { return model.getTempoMap().getNumSegments(); }
+    const GeoTimeMath::SolverContext& getSolverContext() const { return model.getSolverContext(); }
+    bool isOutputReady() const { return isGenerated; }
+
+    // Output events the last generateOutput kept in place / had to create
+    juce::int64 getLastReusedEventCount() const { return lastReusedEvents; }
+    juce::int64 getLastCreatedEventCount() const { return lastCreatedEvents; }
 
 private:
     MidiGridModel model;
-    juce::MidiFile generatedMidi;
+    const ModelCache* modelCache = nullptr;
     bool isGenerated = false;
 
-    juce::String midiToString(const juce::MidiFile& file, const juce::String& title);
+    // In-memory output, kept between generations. Each event is its rounded tick, the event
+    // table index behind it and the StepTimeArray placement its bucket was placed at; messages are only turned into bytes when the file is written, and
+    // then read in place from the model, so sysex and long meta payloads are never copied per
+    // repetition. The storage is reserved to the exact per-track count before each generation
+    // and reused by the next, so regenerating allocates nothing once the output has been built.
+    // Track 0's tempo / time signature header and every EndOfTrack are written by saveFile.
+    struct OutputTrack {
+        std::vector<juce::int64> ticks;
+        std::vector<int> order;  // order[i] is the event table index of the i-th event
+        std::vector<int> placements;
+        juce::int64 endTick = 0; // EndOfTrack position
+    };
+    std::vector<OutputTrack> outputTracks;
+    std::vector<TrackEmitter> emitters; // Reorder windows, reused too
+    juce::int64 lastReusedEvents = 0, lastCreatedEvents = 0;
+    int keptSteps = 0;           // N of the kept output, 0 when there is none
+    double keptStepScale = 1.0;
+    int generationThreads = 0;
+
+    PerfStats stats;         // The model and its solver context point at this while enabled
+    bool statsEnabled = false;
+    PerfStats* getActiveStats() { return statsEnabled ? &stats : nullptr; }
+
+    StepTimeTable stepTable;
+    StepTimeArray stepTimes; // Every step of the last in-memory generation, shared by its track passes
+
+    void truncateOutputTrack(int track, size_t numGenerated);
+
+    // How much of the kept output a generation can start from
+    enum class Reuse { None, Retime, Extend };
+
+    // One track's generation over stepTimes: rebuilds, retimes or continues outputTracks[track]
+    // using emitters[track] and touches nothing else, so different tracks can run
+    // concurrently. False if cancelled.
+    bool generateTrack(int track, int totalSteps, Reuse reuse, const std::function<bool(double)>& progress,
+                       juce::int64& reused, juce::int64& created);
+
+    // Recomputes a kept track's ticks from stepTimes; false (track half written) if the new
+    // times would reorder it
+    bool retimeTrack(int track);
+    template <bool HasMeta> bool retimeTrackKernel(int track);
+
+    // Cuts a kept track back to the events flushed before resumeStep and re-queues the ones
+    // still pending in the track's window. Returns the number of events kept.
+    int resumeTrack(int track, int resumeStep);
+
+    // How often each bucket is placed in an output of totalSteps steps (numBuckets entries)
+    std::vector<juce::int64> getBucketPlacementCounts(int totalSteps) const;
+    juce::Result writeInMemory(juce::FileOutputStream& stream);
+
+    // Streaming export state (output is produced during saveFile)
+    bool streamingExport = false;
+    int pendingSteps = 0;
+    double pendingStepScale = 1.0;
+    std::vector<juce::int64> streamedTrackEvents;
+
+    juce::Result writeStreaming(juce::FileOutputStream& stream, const ProgressCallback& progress);
+    int getTempoMicrosecondsPerQuarter() const;
+
+    JUCE_DECLARE_NON_COPYABLE(MidiTransformEngine)
 };
\ No newline at end of file
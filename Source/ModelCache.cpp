@@ -0,0 +1,242 @@
+/*
+  ==============================================================================
+    ModelCache.cpp
+  ==============================================================================
+*/
+#include "ModelCache.h"
+#include "MidiGridModel.h"
+#include <cstring>
+
+namespace
+{
+    // Entry layout: this header, then the arrays in the order below, each padded to 8 bytes.
+    // Values are in host byte order; 'byteOrder' rejects entries written on another endianness.
+    struct EntryHeader {
+        char magic[4];
+        juce::uint32 version;
+        juce::uint32 byteOrder;
+        juce::uint32 numTracks;
+        juce::uint64 contentHash;
+        juce::uint64 sourceSize;
+        juce::int64 modificationTime;
+        juce::int32 timeFormat;
+        juce::int32 fileType;
+        double bpm;
+        double totalDuration;
+        juce::uint32 numTimePoints;
+        juce::uint32 numDeltas;
+        juce::uint32 numBucketStarts;
+        juce::uint32 numEvents;
+        juce::uint64 blobPoolSize;
+        juce::uint32 numTempoSegments;
+        juce::uint32 reserved;
+    };
+
+    const char kMagic[4] = { 'C', 'S', 'G', 'M' };
+    constexpr juce::uint32 kByteOrderMark = 0x01020304;
+
+    size_t padded(size_t bytes) { return (bytes + 7) & ~(size_t)7; }
+
+    template <typename T>
+    bool writeArray(juce::OutputStream& out, const std::vector<T>& values)
+    {
+        static const char zeros[8] = {};
+        size_t bytes = values.size() * sizeof(T);
+        return (bytes == 0 || out.write(values.data(), bytes))
+            && out.write(zeros, padded(bytes) - bytes);
+    }
+
+    template <typename T>
+    bool readArray(const juce::uint8* data, size_t size, size_t& pos, size_t count, std::vector<T>& values)
+    {
+        size_t bytes = count * sizeof(T);
+        if (count > size / sizeof(T) || pos + padded(bytes) > size) return false;
+
+        values.resize(count);
+        if (bytes > 0) std::memcpy(values.data(), data + pos, bytes);
+        pos += padded(bytes);
+        return true;
+    }
+}
+
+juce::File ModelCache::getDefaultDirectory()
+{
+    return juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory)
+        .getChildFile("CycleSnap").getChildFile("ModelCache");
+}
+
+juce::uint64 ModelCache::hashContent(const juce::uint8* data, size_t size)
+{
+    // Multiply-xorshift over 8-byte words, then the tail bytes
+    const juce::uint64 k = 0x9e3779b97f4a7c15ull;
+    juce::uint64 h = 0xcbf29ce484222325ull ^ (juce::uint64)size;
+    size_t i = 0;
+
+    for (; i + 8 <= size; i += 8) {
+        juce::uint64 w;
+        std::memcpy(&w, data + i, 8);
+        h = (h ^ w) * k;
+        h ^= h >> 29;
+    }
+    for (; i < size; ++i) {
+        h = (h ^ data[i]) * k;
+        h ^= h >> 29;
+    }
+    return h;
+}
+
+juce::File ModelCache::getEntryFile(juce::uint64 contentHash, juce::int64 modificationTime) const
+{
+    return directory.getChildFile(juce::String::toHexString((juce::int64)contentHash).paddedLeft('0', 16)
+        + "_" + juce::String::toHexString(modificationTime) + ".cgm");
+}
+
+bool ModelCache::restore(MidiGridModel& model, juce::uint64 contentHash, juce::int64 modificationTime) const
+{
+    auto entryFile = getEntryFile(contentHash, modificationTime);
+    if (!entryFile.existsAsFile()) return false;
+
+    juce::MemoryMappedFile entry(entryFile, juce::MemoryMappedFile::readOnly);
+    const auto* data = static_cast<const juce::uint8*>(entry.getData());
+    size_t size = entry.getSize();
+
+    EntryHeader header;
+    if (data == nullptr || size < sizeof(header)) return false;
+    std::memcpy(&header, data, sizeof(header));
+
+    auto& source = model.source;
+    if (std::memcmp(header.magic, kMagic, 4) != 0 || header.version != kFormatVersion
+        || header.byteOrder != kByteOrderMark || header.contentHash != contentHash
+        || header.modificationTime != modificationTime || header.sourceSize != source.getMappedSize()
+        || header.numTracks == 0)
+        return false;
+
+    size_t pos = padded(sizeof(header));
+    std::vector<juce::int32> trackCounts;
+    std::vector<double> timePoints, deltas, tempo;
+    auto& table = model.events;
+
+    bool ok = readArray(data, size, pos, header.numTracks, trackCounts)
+        && readArray(data, size, pos, header.numTimePoints, timePoints)
+        && readArray(data, size, pos, header.numDeltas, deltas)
+        && readArray(data, size, pos, header.numBucketStarts, table.bucketStarts)
+        && readArray(data, size, pos, header.numEvents, table.grooveOffsets)
+        && readArray(data, size, pos, header.numEvents, table.trackIndices)
+        && readArray(data, size, pos, header.numEvents, table.payloads)
+        && readArray(data, size, pos, header.numEvents, table.sizes)
+        && readArray(data, size, pos, (size_t)header.blobPoolSize, table.blobPool)
+        && readArray(data, size, pos, (size_t)header.numTempoSegments * 2, tempo);
+
+    // A damaged entry must not be able to send the table out of bounds
+    if (ok) ok = !deltas.empty() && !table.bucketStarts.empty() && table.bucketStarts.front() == 0
+                 && table.bucketStarts.back() == header.numEvents
+                 && std::is_sorted(table.bucketStarts.begin(), table.bucketStarts.end());
+
+    for (juce::uint32 i = 0; ok && i < header.numEvents; ++i) {
+        auto eventSize = table.sizes[i] & ~GridEventTable::kExternalFlag;
+        auto limit = (table.sizes[i] & GridEventTable::kExternalFlag) ? (juce::uint64)source.getMappedSize()
+                                                                      : header.blobPoolSize;
+        ok = table.trackIndices[i] < header.numTracks
+            && (eventSize <= GridEventTable::kMaxPackedSize || (juce::uint64)table.payloads[i] + eventSize <= limit);
+    }
+
+    if (!ok) {
+        table.clear();
+        return false;
+    }
+
+    table.externalData = source.getMappedData();
+    source.restoreTrackInfo(header.timeFormat, header.fileType, std::vector<int>(trackCounts.begin(), trackCounts.end()));
+
+    model.midiFormat = header.fileType;
+    model.initialBpm = header.bpm;
+
+    // (tick, microseconds per quarter) per segment, replayed through addChange
+    model.tempoMap.reset(header.timeFormat);
+    for (size_t i = 0; i + 1 < tempo.size(); i += 2)
+        model.tempoMap.addChange(tempo[i], tempo[i + 1]);
+    model.totalDurationTicks = header.totalDuration;
+    model.timePoints = std::move(timePoints);
+    model.segmentDeltas = std::move(deltas);
+    return true;
+}
+
+bool ModelCache::store(const MidiGridModel& model, juce::uint64 contentHash, juce::int64 modificationTime) const
+{
+    if (!model.isLoaded() || !directory.createDirectory().wasOk()) return false;
+
+    const auto& source = model.source;
+    const auto& table = model.events;
+
+    EntryHeader header{};
+    std::memcpy(header.magic, kMagic, 4);
+    header.version = kFormatVersion;
+    header.byteOrder = kByteOrderMark;
+    header.numTracks = (juce::uint32)source.getNumTracks();
+    header.contentHash = contentHash;
+    header.sourceSize = (juce::uint64)source.getMappedSize();
+    header.modificationTime = modificationTime;
+    header.timeFormat = source.getTimeFormat();
+    header.fileType = source.getFileType();
+    header.bpm = model.initialBpm;
+    header.totalDuration = model.totalDurationTicks;
+    header.numTimePoints = (juce::uint32)model.timePoints.size();
+    header.numDeltas = (juce::uint32)model.segmentDeltas.size();
+    header.numBucketStarts = (juce::uint32)table.bucketStarts.size();
+    header.numEvents = (juce::uint32)table.grooveOffsets.size();
+    header.blobPoolSize = (juce::uint64)table.blobPool.size();
+    header.numTempoSegments = (juce::uint32)model.tempoMap.getNumSegments();
+
+    std::vector<double> tempo;
+    for (const auto& segment : model.tempoMap.getSegments()) {
+        tempo.push_back(segment.tick);
+        tempo.push_back(segment.microsecondsPerQuarter);
+    }
+
+    std::vector<juce::int32> trackCounts;
+    for (int t = 0; t < source.getNumTracks(); ++t) trackCounts.push_back(source.getNumEvents(t));
+
+    auto entryFile = getEntryFile(contentHash, modificationTime);
+    juce::TemporaryFile temp(entryFile);
+
+    {
+        juce::FileOutputStream out(temp.getFile());
+        if (!out.openedOk()) return false;
+
+        static const char zeros[8] = {};
+        bool ok = out.write(&header, sizeof(header))
+            && out.write(zeros, padded(sizeof(header)) - sizeof(header))
+            && writeArray(out, trackCounts)
+            && writeArray(out, model.timePoints)
+            && writeArray(out, model.segmentDeltas)
+            && writeArray(out, table.bucketStarts)
+            && writeArray(out, table.grooveOffsets)
+            && writeArray(out, table.trackIndices)
+            && writeArray(out, table.payloads)
+            && writeArray(out, table.sizes)
+            && writeArray(out, table.blobPool)
+            && writeArray(out, tempo);
+
+        out.flush();
+        if (!ok || out.getStatus().failed()) return false;
+    }
+
+    if (!temp.overwriteTargetFileWithTemporary()) return false;
+
+    pruneOldEntries();
+    return true;
+}
+
+void ModelCache::pruneOldEntries() const
+{
+    auto entries = directory.findChildFiles(juce::File::findFiles, false, "*.cgm");
+    if ((int)entries.size() <= kMaxEntries) return;
+
+    // Oldest first
+    std::sort(entries.begin(), entries.end(), [](const juce::File& a, const juce::File& b) {
+        return a.getLastModificationTime() < b.getLastModificationTime();
+        });
+
+    for (int i = 0; i < (int)entries.size() - kMaxEntries; ++i)
+        entries[i].deleteFile();
+}
@@ -0,0 +1,46 @@
+/*
+  ==============================================================================
+    ModelCache.h
+
+    On-disk cache of analysed grid models.
+    An entry holds everything MidiGridModel derives from a source file (grid
+    lines, segment deltas, the bucketed event table, BPM, PPQ and per-track
+    counts) in a flat, versioned binary layout, keyed by the source's content
+    hash and modification time. A hit costs one hash of the mapped source and
+    one mapping of the entry, bulk-copied into the model: no parsing, merging
+    or bucketing.
+  ==============================================================================
+*/
+#pragma once
+#include <JuceHeader.h>
+
+class MidiGridModel;
+
+class ModelCache
+{
+public:
+    explicit ModelCache(const juce::File& cacheDirectory) : directory(cacheDirectory) {}
+
+    // <user application data>/CycleSnap/ModelCache
+    static juce::File getDefaultDirectory();
+
+    // Fast 64-bit hash of the source bytes (not cryptographic)
+    static juce::uint64 hashContent(const juce::uint8* data, size_t size);
+
+    // Fills 'model' from the entry for this source. The model's source must already be
+    // mapped (meta events in the table point into it). False on a miss or a bad entry.
+    bool restore(MidiGridModel& model, juce::uint64 contentHash, juce::int64 modificationTime) const;
+
+    // Writes (or replaces) the entry for the model's current source. Safe to call from
+    // several threads: entries are written to a temporary file and moved into place.
+    bool store(const MidiGridModel& model, juce::uint64 contentHash, juce::int64 modificationTime) const;
+
+    static constexpr juce::uint32 kFormatVersion = 3; // 3: sysex of up to 3 bytes is packed
+    static constexpr int kMaxEntries = 512;
+
+private:
+    juce::File getEntryFile(juce::uint64 contentHash, juce::int64 modificationTime) const;
+    void pruneOldEntries() const;
+
+    juce::File directory;
+};
@@ -0,0 +1,91 @@
+/*
+  ==============================================================================
+    OutputCurve.cpp
+  ==============================================================================
+*/
+#include "OutputCurve.h"
+#include <algorithm>
+
+void OutputCurve::reset(double length)
+{
+    totalTime = std::max(0.0, length);
+    numSteps = 0;
+    numEvents = 0;
+    minDuration = maxDuration = 0.0;
+
+    levels.clear();
+    levels.emplace_back((size_t)kBaseBins);
+}
+
+int OutputCurve::binFor(double time) const
+{
+    if (totalTime <= 0.0) return 0;
+    return std::clamp((int)(time / totalTime * kBaseBins), 0, kBaseBins - 1);
+}
+
+void OutputCurve::addStep(double startTime, double endTime)
+{
+    float duration = (float)(endTime - startTime);
+
+    if (numSteps == 0) minDuration = maxDuration = duration;
+    minDuration = std::min(minDuration, (double)duration);
+    maxDuration = std::max(maxDuration, (double)duration);
+    ++numSteps;
+
+    // A long step covers several bins; every bin boundary is crossed by one step only,
+    // so the whole build touches at most N + kBaseBins bins
+    auto& bins = levels[0];
+    for (int b = binFor(startTime), last = binFor(endTime); b <= last; ++b) {
+        auto& bin = bins[(size_t)b];
+        if (bin.maxDuration == 0.0f) {
+            bin.minDuration = bin.maxDuration = duration;
+        }
+        else {
+            bin.minDuration = std::min(bin.minDuration, duration);
+            bin.maxDuration = std::max(bin.maxDuration, duration);
+        }
+    }
+}
+
+void OutputCurve::addEvents(double time, int count)
+{
+    if (count <= 0) return;
+    levels[0][(size_t)binFor(time)].events += (uint32_t)count;
+    numEvents += count;
+}
+
+void OutputCurve::finish()
+{
+    levels.resize(1);
+
+    while ((int)levels.back().size() / 2 >= kMinBins) {
+        const auto& finer = levels.back();
+        std::vector<Bin> coarser(finer.size() / 2);
+
+        for (size_t i = 0; i < coarser.size(); ++i) {
+            const auto& a = finer[2 * i];
+            const auto& b = finer[2 * i + 1];
+            auto& bin = coarser[i];
+
+            bin.events = a.events + b.events;
+            if (a.maxDuration == 0.0f) { bin.minDuration = b.minDuration; bin.maxDuration = b.maxDuration; }
+            else if (b.maxDuration == 0.0f) { bin.minDuration = a.minDuration; bin.maxDuration = a.maxDuration; }
+            else {
+                bin.minDuration = std::min(a.minDuration, b.minDuration);
+                bin.maxDuration = std::max(a.maxDuration, b.maxDuration);
+            }
+        }
+
+        levels.push_back(std::move(coarser));
+    }
+}
+
+const std::vector<OutputCurve::Bin>& OutputCurve::getLevelFor(int minBins) const
+{
+    static const std::vector<Bin> none;
+    if (levels.empty()) return none;
+
+    for (size_t l = levels.size(); l-- > 1;)
+        if ((int)levels[l].size() >= minBins) return levels[l];
+    return levels[0];
+}
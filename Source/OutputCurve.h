@@ -0,0 +1,57 @@
+/*
+  ==============================================================================
+    OutputCurve.h
+
+    Decimated overview of one output for the visualizer: the stretched step
+    durations (min/max) and the number of placed events, binned over the output
+    time. Level 0 has kBaseBins bins and every further level halves it, so a
+    view of any width reads at most two bins per column, however many steps or
+    events the output has. Built in O(N + kBaseBins).
+  ==============================================================================
+*/
+#pragma once
+#include <vector>
+#include <cstdint>
+
+class OutputCurve
+{
+public:
+    struct Bin {
+        float minDuration = 0.0f;  // Shortest / longest step overlapping the bin, in ticks
+        float maxDuration = 0.0f;  // (0 when no step overlaps it)
+        uint32_t events = 0;       // Events placed inside the bin
+    };
+
+    OutputCurve() = default;
+
+    // Building: reset with the output's length, add every step and every placed group of
+    // events, then finish() to derive the coarser levels
+    void reset(double totalTime);
+    void addStep(double startTime, double endTime);
+    void addEvents(double time, int count);
+    void finish();
+
+    bool isEmpty() const { return levels.empty() || numSteps == 0; }
+
+    // Coarsest level with at least minBins bins (level 0 if none is that fine)
+    const std::vector<Bin>& getLevelFor(int minBins) const;
+
+    double getTotalTime() const { return totalTime; }
+    int getNumSteps() const { return numSteps; }
+    int64_t getNumEvents() const { return numEvents; }
+    double getMinDuration() const { return minDuration; }
+    double getMaxDuration() const { return maxDuration; }
+
+    static constexpr int kBaseBins = 4096;
+    static constexpr int kMinBins = 32; // Coarsest level kept
+
+private:
+    int binFor(double time) const;
+
+    double totalTime = 0.0;
+    int numSteps = 0;
+    int64_t numEvents = 0;
+    double minDuration = 0.0, maxDuration = 0.0;
+
+    std::vector<std::vector<Bin>> levels; // levels[l] has kBaseBins >> l bins
+};
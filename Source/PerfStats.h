@@ -0,0 +1,124 @@
+/*
+  ==============================================================================
+    PerfStats.h
+
+    Per-stage timers and counters for the load / solve / generate / write
+    pipeline, so a slow file shows which stage is responsible without a
+    profiler. Stages are timed with ScopedTimer at stage granularity (never per
+    event); a timer constructed with a null PerfStats does not read the clock,
+    and building with CYCLESNAP_PERF_STATS=0 compiles every timer away.
+  ==============================================================================
+*/
+#pragma once
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+#ifndef CYCLESNAP_PERF_STATS
+ #define CYCLESNAP_PERF_STATS 1
+#endif
+
+class PerfStats
+{
+public:
+    enum class Stage {
+        Load,            // Whole loadSource: mapping, parsing or cache restore (count = events)
+        AnalyzeTimeline, // Grid line extraction (count = grid lines)
+        SegmentEvents,   // Bucketing the events onto the grid (count = events)
+        SolveBracket,    // Search range expansion (count = duration evaluations)
+        SolveIterate,    // Newton / bisection / N search (count = duration evaluations)
+        SolveVerify,     // Rounded-tick drift check (count = steps)
+        Generate,        // Building the in-memory output (count = events)
+        Sort,            // Reorder windows, fused into Generate / Write (count = events moved back)
+        Write,           // saveFile, including streamed generation (count = events)
+        NumStages
+    };
+
+    static constexpr int kNumStages = (int)Stage::NumStages;
+
+    struct Entry {
+        int64_t calls = 0;
+        double ms = 0.0;
+        int64_t count = 0; // Stage-specific, see Stage
+    };
+
+    void clear() { entries = {}; }
+
+    void add(Stage stage, double ms, int64_t count = 0)
+    {
+        auto& e = entries[(size_t)stage];
+        ++e.calls;
+        e.ms += ms;
+        e.count += count;
+    }
+
+    // Counts without a call or a time (for work measured inside another stage)
+    void addCount(Stage stage, int64_t count) { entries[(size_t)stage].count += count; }
+
+    const Entry& get(Stage stage) const { return entries[(size_t)stage]; }
+
+    static const char* getStageName(Stage stage)
+    {
+        static const char* const names[kNumStages] = {
+            "load", "analyzeTimeline", "segmentEvents", "solveBracket", "solveIterate",
+            "solveVerify", "generate", "sort", "write"
+        };
+        return names[(size_t)stage];
+    }
+
+    // A header plus one line per stage that ran: name, calls, total ms, count
+    std::string format() const
+    {
+        char header[128];
+        std::snprintf(header, sizeof(header), "%-16s %6s   %12s    %14s\n", "stage", "calls", "time", "count");
+        std::string s = header;
+        for (int i = 0; i < kNumStages; ++i) {
+            const auto& e = entries[(size_t)i];
+            if (e.calls == 0 && e.count == 0) continue;
+
+            char line[128];
+            std::snprintf(line, sizeof(line), "%-16s %6lld x %12.3f ms %14lld\n", getStageName((Stage)i),
+                (long long)e.calls, e.ms, (long long)e.count);
+            s += line;
+        }
+        return s;
+    }
+
+    // Adds the stage's elapsed time to 'stats' when it goes out of scope
+    class ScopedTimer
+    {
+    public:
+#if CYCLESNAP_PERF_STATS
+        ScopedTimer(PerfStats* s, Stage st) : stats(s), stage(st)
+        {
+            if (stats != nullptr) start = std::chrono::steady_clock::now();
+        }
+
+        ~ScopedTimer()
+        {
+            if (stats == nullptr) return;
+            std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+            stats->add(stage, elapsed.count(), count);
+        }
+
+        void addCount(int64_t n) { count += n; }
+
+    private:
+        PerfStats* stats;
+        Stage stage;
+        int64_t count = 0;
+        std::chrono::steady_clock::time_point start;
+#else
+        ScopedTimer(PerfStats*, Stage) {}
+        void addCount(int64_t) {}
+#endif
+
+        ScopedTimer(const ScopedTimer&) = delete;
+        ScopedTimer& operator=(const ScopedTimer&) = delete;
+    };
+
+private:
+    std::array<Entry, kNumStages> entries{};
+};
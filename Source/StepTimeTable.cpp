@@ -0,0 +1,111 @@
+/*
+  ==============================================================================
+    StepTimeTable.cpp
+  ==============================================================================
+*/
+#include "StepTimeTable.h"
+#include <algorithm>
+
+void StepTimeTable::clear()
+{
+    deltas.clear();
+    numSteps = 0;
+    stepScale = 1.0;
+    endTime = 0.0;
+    checkpointTimes.clear();
+    checkpointScales.clear();
+}
+
+void StepTimeTable::build(const std::vector<double>& patternDeltas, int totalSteps, double s_step)
+{
+    clear();
+    deltas = patternDeltas;
+    stepScale = s_step;
+    numSteps = deltas.empty() ? 0 : std::max(0, totalSteps);
+
+    size_t numCheckpoints = (size_t)numSteps / kCheckpointInterval + 1;
+    checkpointTimes.reserve(numCheckpoints);
+    checkpointScales.reserve(numCheckpoints);
+
+    Cursor cursor(deltas, s_step);
+    for (int k = 0; k < numSteps; ++k, cursor.advance()) {
+        if (k % kCheckpointInterval == 0) {
+            checkpointTimes.push_back(cursor.startTime);
+            checkpointScales.push_back(cursor.scaleCursor);
+        }
+    }
+
+    // Step N (the end) gets a checkpoint too when it falls on the interval
+    if (numSteps % kCheckpointInterval == 0) {
+        checkpointTimes.push_back(cursor.startTime);
+        checkpointScales.push_back(cursor.scaleCursor);
+    }
+    endTime = cursor.startTime;
+}
+
+bool StepTimeTable::matches(const std::vector<double>& patternDeltas, int totalSteps, double s_step) const
+{
+    int steps = patternDeltas.empty() ? 0 : std::max(0, totalSteps);
+    return steps == numSteps && s_step == stepScale && patternDeltas == deltas && !checkpointTimes.empty();
+}
+
+StepTimeTable::Cursor StepTimeTable::getStep(int step) const
+{
+    if (checkpointTimes.empty()) return Cursor(deltas, stepScale);
+
+    step = std::clamp(step, 0, numSteps);
+    size_t c = (size_t)(step / kCheckpointInterval);
+
+    Cursor cursor(deltas, checkpointScales[c], checkpointTimes[c]);
+    while (cursor.getStep() < step) cursor.advance();
+    return cursor;
+}
+
+StepTimeTable::Cursor StepTimeTable::findStep(double tick) const
+{
+    if (checkpointTimes.empty()) return Cursor(deltas, stepScale);
+
+    // Last checkpoint at or before 'tick', then forward while the next step still starts in time
+    auto after = std::upper_bound(checkpointTimes.begin(), checkpointTimes.end(), tick);
+    size_t c = after == checkpointTimes.begin() ? 0 : (size_t)(after - checkpointTimes.begin()) - 1;
+
+    Cursor cursor(deltas, checkpointScales[c], checkpointTimes[c]);
+    while (cursor.getStep() < numSteps && cursor.getEndTime() <= tick) cursor.advance();
+    return cursor;
+}
+
+void StepTimeArray::clear()
+{
+    deltas.clear();
+    numSegments = 0;
+    numSteps = 0;
+    stepScale = 1.0;
+    baseTimes.clear();
+    baseScales.clear();
+}
+
+void StepTimeArray::build(const std::vector<double>& patternDeltas, int totalSteps, double s_step)
+{
+    // Keeps the storage for the next build
+    deltas = patternDeltas;
+    numSegments = (int)deltas.size();
+    stepScale = s_step;
+    numSteps = deltas.empty() ? 0 : std::max(0, totalSteps);
+
+    baseTimes.resize((size_t)numSteps + 1);
+    baseScales.resize((size_t)numSteps + 1);
+    baseTimes[0] = 0.0;
+    baseScales[0] = 1.0;
+
+    StepTimeTable::Cursor cursor(deltas, s_step);
+    for (int k = 0; k < numSteps; ++k, cursor.advance()) {
+        baseTimes[(size_t)k + 1] = cursor.getEndTime();
+        baseScales[(size_t)k + 1] = cursor.getScale();
+    }
+}
+
+bool StepTimeArray::matches(const std::vector<double>& patternDeltas, int totalSteps, double s_step) const
+{
+    int steps = patternDeltas.empty() ? 0 : std::max(0, totalSteps);
+    return steps == numSteps && s_step == stepScale && patternDeltas == deltas && !baseTimes.empty();
+}
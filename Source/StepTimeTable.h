@@ -0,0 +1,155 @@
+/*
+  ==============================================================================
+    StepTimeTable.h
+
+    Start times of the output steps for one (pattern, N, s_step), for seeking
+    without generating from step 0. Only every kCheckpointInterval-th step is
+    stored (start time and s^k); the steps in between are replayed from the
+    checkpoint before them with the same arithmetic generation uses, so a
+    lookup gives bit-identical times to a full walk at a bounded cost.
+    Memory is about 40 bytes per kCheckpointInterval steps. StepTimeArray
+    keeps every step instead, for generators making several full passes.
+  ==============================================================================
+*/
+#pragma once
+#include <vector>
+#include "GeometricTimeSolver.h"
+
+class StepTimeTable
+{
+public:
+    /**
+     * Position at the start of one step. Advancing is O(1) and allocation free, so a cursor
+     * can drive real-time playback. It refers to the deltas it was created from.
+     */
+    class Cursor
+    {
+    public:
+        Cursor() = default; // Not usable until assigned
+        Cursor(const std::vector<double>& patternDeltas, double s_step)
+            : deltas(&patternDeltas), scaleCursor(s_step) {}
+
+        int getStep() const { return scaleCursor.getStep(); }
+        int getSegment() const { return segment; }            // Source segment played by this step
+        double getScale() const { return scaleCursor.getScale(); } // s_step^step
+        double getStartTime() const { return startTime; }
+        double getEndTime() const { return startTime + (*deltas)[(size_t)segment] * scaleCursor.getScale(); }
+
+        void advance()
+        {
+            startTime = getEndTime();
+            scaleCursor.advance();
+            if (++segment == (int)deltas->size()) segment = 0;
+        }
+
+    private:
+        friend class StepTimeTable;
+
+        Cursor(const std::vector<double>& patternDeltas, const GeoTimeMath::StepScaleCursor& scale, double start)
+            : deltas(&patternDeltas), scaleCursor(scale), startTime(start),
+              segment(patternDeltas.empty() ? 0 : scale.getStep() % (int)patternDeltas.size()) {}
+
+        const std::vector<double>* deltas = nullptr;
+        GeoTimeMath::StepScaleCursor scaleCursor{ 1.0 };
+        double startTime = 0.0;
+        int segment = 0;
+    };
+
+    StepTimeTable() = default;
+
+    // O(N). An empty pattern gives a table with no steps.
+    void build(const std::vector<double>& patternDeltas, int totalSteps, double s_step);
+    void clear();
+
+    bool matches(const std::vector<double>& patternDeltas, int totalSteps, double s_step) const;
+
+    int getNumSteps() const { return numSteps; }
+    double getStepScaleFactor() const { return stepScale; }
+    double getEndTime() const { return endTime; } // End of the last step
+
+    // Cursor at step k (0 <= k <= N; step N is the end). O(kCheckpointInterval).
+    Cursor getStep(int step) const;
+
+    // Cursor at the last step starting at or before 'tick' (step 0 for earlier ticks,
+    // step N at or after the end). O(log N + kCheckpointInterval).
+    Cursor findStep(double tick) const;
+
+    static constexpr int kCheckpointInterval = 64;
+
+private:
+    std::vector<double> deltas;
+    int numSteps = 0;
+    double stepScale = 1.0;
+    double endTime = 0.0;
+
+    // Checkpoint c is step c * kCheckpointInterval
+    std::vector<double> checkpointTimes;
+    std::vector<GeoTimeMath::StepScaleCursor> checkpointScales;
+};
+
+/**
+ * Every step of an output in flat arrays, for generators that walk all N steps more than
+ * once (one pass per track): built once per (N, s_step) with the Cursor arithmetic, so the
+ * times are bit-identical to a walk, then only read, from any number of threads.
+ * Placement p holds the base time and scale of the buckets placed after step p - 1;
+ * placement 0 is the start (time 0, scale 1). Memory is 16 bytes per step.
+ */
+class StepTimeArray
+{
+public:
+    // Same interface as StepTimeTable::Cursor, reading the arrays instead of advancing the arithmetic
+    class Cursor
+    {
+    public:
+        int getStep() const { return step; }
+        int getSegment() const { return segment; }
+        double getScale() const { return array->baseScales[(size_t)step + 1]; }
+        double getStartTime() const { return array->baseTimes[(size_t)step]; }
+        double getEndTime() const { return array->baseTimes[(size_t)step + 1]; }
+
+        void advance()
+        {
+            ++step;
+            if (++segment == array->numSegments) segment = 0;
+        }
+
+    private:
+        friend class StepTimeArray;
+        explicit Cursor(const StepTimeArray& a) : array(&a) {}
+
+        const StepTimeArray* array;
+        int step = 0;
+        int segment = 0;
+    };
+
+    // O(N). An empty pattern gives an array with no steps.
+    void build(const std::vector<double>& patternDeltas, int totalSteps, double s_step);
+    void clear();
+
+    bool matches(const std::vector<double>& patternDeltas, int totalSteps, double s_step) const;
+
+    int getNumSteps() const { return numSteps; }
+    double getEndTime() const { return baseTimes.empty() ? 0.0 : baseTimes.back(); }
+
+    double getBaseTime(int placement) const { return baseTimes[(size_t)placement]; }
+    double getBaseScale(int placement) const { return baseScales[(size_t)placement]; }
+
+    // Cursor at step 0, or at step k (0 <= k <= N)
+    Cursor begin() const { return Cursor(*this); }
+    Cursor getStep(int step) const
+    {
+        Cursor cursor(*this);
+        cursor.step = step;
+        cursor.segment = numSegments > 0 ? step % numSegments : 0;
+        return cursor;
+    }
+
+private:
+    std::vector<double> deltas;
+    int numSegments = 0;
+    int numSteps = 0;
+    double stepScale = 1.0;
+
+    std::vector<double> baseTimes;  // numSteps + 1 entries; baseTimes[k] is also the start of step k
+    std::vector<double> baseScales; // numSteps + 1 entries; baseScales[k + 1] is s_step^k
+};
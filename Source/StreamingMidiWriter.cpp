@@ -0,0 +1,106 @@
+/*
+  ==============================================================================
+    StreamingMidiWriter.cpp
+  ==============================================================================
+*/
+#include "StreamingMidiWriter.h"
+
+bool StreamingMidiWriter::writeHeader(int format, int numTracks, int ppq)
+{
+    return out.write("MThd", 4)
+        && out.writeIntBigEndian(6)
+        && out.writeShortBigEndian((short)format)
+        && out.writeShortBigEndian((short)numTracks)
+        && out.writeShortBigEndian((short)ppq);
+}
+
+bool StreamingMidiWriter::beginTrack()
+{
+    lastTick = 0;
+    eventsInTrack = 0;
+    runningStatus = 0;
+    endOfTrackWritten = false;
+
+    // Length is unknown until the track is closed
+    if (!out.write("MTrk", 4) || !out.writeIntBigEndian(0)) return false;
+    chunkStart = out.getPosition();
+    return true;
+}
+
+bool StreamingMidiWriter::writeEvent(juce::int64 tick, const juce::uint8* data, int size)
+{
+    if (size <= 0 || endOfTrackWritten) return true;
+
+    jassert(tick >= lastTick);
+    juce::int64 delta = std::max((juce::int64)0, tick - lastTick);
+    lastTick = std::max(lastTick, tick);
+
+    // A delta must fit a four-byte VLQ; longer gaps are bridged with empty text events
+    while (delta > kMaxDelta) {
+        const juce::uint8 filler[] = { 0xff, 0x01, 0x00 };
+        if (!writeVariableLength((juce::uint32)kMaxDelta) || !out.write(filler, sizeof(filler))) return false;
+        runningStatus = 0;
+        delta -= kMaxDelta;
+    }
+
+    if (!writeVariableLength((juce::uint32)delta)) return false;
+
+    juce::uint8 status = data[0];
+    bool ok = true;
+
+    if (status == 0xf0) {
+        // Sysex: F0 <length> <data after F0>
+        ok = out.writeByte((char)0xf0)
+            && writeVariableLength((juce::uint32)(size - 1))
+            && out.write(data + 1, (size_t)(size - 1));
+        runningStatus = 0;
+    }
+    else if (status == 0xff) {
+        // Meta events already carry their own VLQ length
+        ok = out.write(data, (size_t)size);
+        runningStatus = 0;
+        if (size > 1 && data[1] == 0x2f) endOfTrackWritten = true;
+    }
+    else if (status < 0xf0 && status == runningStatus && size > 1) {
+        ok = out.write(data + 1, (size_t)(size - 1));
+    }
+    else {
+        ok = out.write(data, (size_t)size);
+        runningStatus = (status < 0xf0) ? status : 0;
+    }
+
+    ++eventsInTrack;
+    return ok;
+}
+
+bool StreamingMidiWriter::endTrack(juce::int64 endTick)
+{
+    if (!endOfTrackWritten) {
+        const juce::uint8 eot[] = { 0xff, 0x2f, 0x00 };
+        if (!writeEvent(std::max(endTick, lastTick), eot, 3)) return false;
+    }
+
+    juce::int64 chunkEnd = out.getPosition();
+
+    // The length field is written as a signed 32-bit value
+    if (chunkEnd - chunkStart > (juce::int64)std::numeric_limits<int>::max()) return false;
+
+    // Back-patch the chunk length, then return to the end of the file
+    return out.setPosition(chunkStart - 4)
+        && out.writeIntBigEndian((int)(chunkEnd - chunkStart))
+        && out.setPosition(chunkEnd);
+}
+
+bool StreamingMidiWriter::writeVariableLength(juce::uint32 value)
+{
+    juce::uint8 bytes[5];
+    int n = 0;
+
+    bytes[n++] = (juce::uint8)(value & 0x7f);
+    while ((value >>= 7) != 0)
+        bytes[n++] = (juce::uint8)((value & 0x7f) | 0x80);
+
+    // Most significant group first
+    std::reverse(bytes, bytes + n);
+    return out.write(bytes, (size_t)n);
+}
\ No newline at end of file
@@ -0,0 +1,44 @@
+/*
+  ==============================================================================
+    StreamingMidiWriter.h
+
+    Writes a Standard MIDI File chunk by chunk, straight to disk.
+    Events go out as they are produced (VLQ deltas encoded on the fly) and each
+    track chunk's length is back-patched when the track is closed, so nothing
+    but the stream buffer is held in memory.
+  ==============================================================================
+*/
+#pragma once
+#include <JuceHeader.h>
+
+class StreamingMidiWriter
+{
+public:
+    explicit StreamingMidiWriter(juce::FileOutputStream& destination) : out(destination) {}
+
+    bool writeHeader(int format, int numTracks, int ppq);
+
+    bool beginTrack();
+    // Events must arrive in non-decreasing tick order within a track
+    bool writeEvent(juce::int64 tick, const juce::uint8* data, int size);
+    bool writeEvent(juce::int64 tick, const juce::MidiMessage& m) { return writeEvent(tick, m.getRawData(), m.getRawDataSize()); }
+    // Appends EndOfTrack at 'endTick' (if none was written) and back-patches the chunk length;
+    // fails if the chunk outgrew its 32-bit length field
+    bool endTrack(juce::int64 endTick);
+
+    juce::int64 getNumEventsInTrack() const { return eventsInTrack; }
+
+private:
+    bool writeVariableLength(juce::uint32 value);
+
+    static constexpr juce::int64 kMaxDelta = 0x0fffffff; // Largest four-byte VLQ
+
+    juce::FileOutputStream& out;
+    juce::int64 chunkStart = 0; // Position of the first byte after the length field
+    juce::int64 lastTick = 0;
+    juce::int64 eventsInTrack = 0;
+    juce::uint8 runningStatus = 0;
+    bool endOfTrackWritten = false;
+
+    JUCE_DECLARE_NON_COPYABLE(StreamingMidiWriter)
+};
\ No newline at end of file
@@ -0,0 +1,39 @@
+/*
+  ==============================================================================
+    TempoMap.cpp
+  ==============================================================================
+*/
+#include "TempoMap.h"
+#include <algorithm>
+
+void TempoMap::reset(int ticksPerQuarter, double bpm)
+{
+    ppq = ticksPerQuarter > 0 ? ticksPerQuarter : 960;
+    segments.assign(1, Segment{ 0.0, 60000000.0 / (bpm > 0.0 ? bpm : 120.0) });
+}
+
+void TempoMap::addChange(double tick, double microsecondsPerQuarter)
+{
+    if (microsecondsPerQuarter <= 0.0) return;
+    tick = std::max(tick, segments.back().tick);
+
+    if (tick == segments.back().tick) {
+        // Replaces the change at this tick; it may now repeat the segment before it
+        segments.back().microsecondsPerQuarter = microsecondsPerQuarter;
+        if (segments.size() > 1 && segments[segments.size() - 2].microsecondsPerQuarter == microsecondsPerQuarter)
+            segments.pop_back();
+        return;
+    }
+
+    const auto& last = segments.back();
+    if (last.microsecondsPerQuarter == microsecondsPerQuarter) return;
+
+    segments.push_back({ tick, microsecondsPerQuarter });
+}
+
+size_t TempoMap::segmentAt(double tick) const
+{
+    auto after = std::upper_bound(segments.begin(), segments.end(), tick,
+        [](double t, const Segment& s) { return t < s.tick; });
+    return after == segments.begin() ? 0 : (size_t)(after - segments.begin()) - 1;
+}
@@ -0,0 +1,46 @@
+/*
+  ==============================================================================
+    TempoMap.h
+
+    The source's tempo map as a sorted index of tempo segments. Each segment
+    starts at a tempo change, so the tempo at a tick is one binary search.
+    Repeated tempi are folded into the segment before them, which keeps long
+    ramp exports compact. Before the first change SMF's default of 120 BPM
+    applies.
+  ==============================================================================
+*/
+#pragma once
+#include <vector>
+#include <cstddef>
+
+class TempoMap
+{
+public:
+    struct Segment {
+        double tick = 0.0;                      // Where this tempo starts
+        double microsecondsPerQuarter = 500000.0;
+    };
+
+    TempoMap() { reset(960); }
+    TempoMap(int ppq, double bpm) { reset(ppq, bpm); } // One tempo throughout
+
+    void reset(int ppq, double bpm = 120.0);
+
+    // Changes must be added in non-decreasing tick order; a later change at the same tick
+    // replaces the earlier one
+    void addChange(double tick, double microsecondsPerQuarter);
+
+    double getMsPerTickAt(double tick) const { return msPerTick(segments[segmentAt(tick)]); }
+    double getMicrosecondsPerQuarterAt(double tick) const { return segments[segmentAt(tick)].microsecondsPerQuarter; }
+
+    int getPPQ() const { return ppq; }
+    int getNumSegments() const { return (int)segments.size(); }
+    const std::vector<Segment>& getSegments() const { return segments; } // Never empty; [0] starts at tick 0
+
+private:
+    size_t segmentAt(double tick) const; // Last segment starting at or before 'tick'
+    double msPerTick(const Segment& s) const { return s.microsecondsPerQuarter / (1000.0 * ppq); }
+
+    int ppq = 960;
+    std::vector<Segment> segments;
+};
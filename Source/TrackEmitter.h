@@ -0,0 +1,115 @@
+/*
+  ==============================================================================
+    TrackEmitter.h
+
+    Keeps one output track in order while its events are being produced.
+    Generation emits events in nearly sorted order (the grid line only moves
+    forward, groove offsets jitter around it), so a short reorder window
+    replaces a full sort: events are insertion-sorted into the window from the
+    back and flushed as soon as no later step can produce anything earlier.
+  ==============================================================================
+*/
+#pragma once
+#include <vector>
+#include <cmath>
+#include "PerfStats.h"
+
+class TrackEmitter
+{
+public:
+    struct Pending {
+        double time;    // Exact (unrounded) tick position
+        int eventIndex; // Index into the model's GridEventTable
+        int placement;  // StepTimeArray placement the event's bucket was placed at
+        bool isMeta;
+    };
+
+    void clear() { window.clear(); head = 0; lastTime = 0.0; numReordered = 0; }
+
+    // Same ordering the old stable sort used: time first, meta events first within 1e-6 ticks.
+    // A track known to hold no meta events (HasMeta = false) skips the tie-break: the result
+    // is the same, since two non-meta events never reorder within 1e-6 ticks.
+    template <bool HasMeta = true>
+    static bool comesBefore(const Pending& a, const Pending& b)
+    {
+        if constexpr (!HasMeta) return b.time - a.time > 1e-6;
+
+        if (std::abs(a.time - b.time) > 1e-6) return a.time < b.time;
+        return a.isMeta && !b.isMeta;
+    }
+
+    template <bool HasMeta = true>
+    void push(double time, int eventIndex, int placement, bool isMeta)
+    {
+        Pending p{ time, eventIndex, placement, isMeta };
+        window.push_back(p);
+
+        // Insertion from the back keeps equal events in production order (stable)
+        size_t i = window.size() - 1;
+        while (i > head && comesBefore<HasMeta>(p, window[i - 1])) {
+            window[i] = window[i - 1];
+            --i;
+        }
+        window[i] = p;
+
+#if CYCLESNAP_PERF_STATS
+        if (i + 1 != window.size()) ++numReordered;
+#endif
+
+        if (time > lastTime) lastTime = time;
+    }
+
+    // Hands every pending event earlier than 'watermark' to sink(time, eventIndex, placement),
+    // in order. The caller guarantees nothing pushed later lands before the watermark.
+    template <typename Sink>
+    void flushBefore(double watermark, Sink&& sink)
+    {
+        while (head < window.size() && window[head].time < watermark - 1e-6) {
+            const auto& p = window[head];
+            sink(p.time, p.eventIndex, p.placement);
+            ++head;
+        }
+        compact();
+    }
+
+    template <typename Sink>
+    void flushAll(Sink&& sink)
+    {
+        for (; head < window.size(); ++head) {
+            const auto& p = window[head];
+            sink(p.time, p.eventIndex, p.placement);
+        }
+        compact();
+    }
+
+    // Continuing an earlier pass from a later step: empties the window, takes the latest time
+    // produced so far, then restore() re-queues the events still pending, already in order
+    void resume(double latestTime) { clear(); lastTime = latestTime; }
+    void restore(const Pending& p)
+    {
+        window.push_back(p);
+        if (p.time > lastTime) lastTime = p.time;
+    }
+
+    double getLastTime() const { return lastTime; }
+    size_t getNumPending() const { return window.size() - head; }
+
+    // Events pushed since clear() that had to move back past an earlier one
+    // (always 0 with CYCLESNAP_PERF_STATS=0)
+    int64_t getNumReordered() const { return numReordered; }
+
+private:
+    void compact()
+    {
+        if (head == window.size()) { window.clear(); head = 0; }
+        else if (head > 1024 && head * 2 > window.size()) {
+            window.erase(window.begin(), window.begin() + (std::ptrdiff_t)head);
+            head = 0;
+        }
+    }
+
+    std::vector<Pending> window;
+    size_t head = 0;
+    double lastTime = 0.0;
+    int64_t numReordered = 0;
+};
\ No newline at end of file
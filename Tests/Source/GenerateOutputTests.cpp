@@ -0,0 +1,167 @@
+/*
+  ==============================================================================
+    GenerateOutputTests.cpp
+  ==============================================================================
+*/
+#include <JuceHeader.h>
+#include "MidiTransformEngine.h"
+#include "StreamingMidiWriter.h"
+
+namespace
+{
+    // 'segments' uneven grid segments; on every line one note per track ends and the next
+    // starts; a few events sit just off the line, so tracks see real groove offsets
+    bool writeSource(const juce::File& file, int segments, int tracks)
+    {
+        file.deleteFile();
+        juce::FileOutputStream stream(file);
+        if (!stream.openedOk()) return false;
+
+        StreamingMidiWriter writer(stream);
+        if (!writer.writeHeader(1, tracks, 960)) return false;
+
+        std::vector<juce::int64> lines{ 0 };
+        for (int b = 0; b < segments; ++b)
+            lines.push_back(lines.back() + 120 + (b * 53 % 7) * 60);
+
+        for (int t = 0; t < tracks; ++t) {
+            if (!writer.beginTrack()) return false;
+            if (t == 0 && !writer.writeEvent(0, juce::MidiMessage::tempoMetaEvent(500000))) return false;
+
+            for (size_t line = 0; line < lines.size(); ++line) {
+                auto onTick = lines[line] + (line % 5 == 0 && line + 1 < lines.size() ? 7 * (t + 1) : 0);
+                auto noteAt = [&](size_t l) { return 36 + (int)((l * 7 + (size_t)t) % 60); };
+
+                if (line > 0 && !writer.writeEvent(lines[line], juce::MidiMessage::noteOff(t + 1, noteAt(line - 1))))
+                    return false;
+                if (line + 1 < lines.size() && !writer.writeEvent(onTick, juce::MidiMessage::noteOn(t + 1, noteAt(line), (juce::uint8)100)))
+                    return false;
+            }
+
+            if (!writer.endTrack(lines.back())) return false;
+        }
+
+        stream.flush();
+        return stream.getStatus().wasOk();
+    }
+
+    // The output's note times per track as the original std::pow step arithmetic gives them:
+    // every step's scale was std::pow(s_step, k), its start the running sum of stretched deltas
+    std::vector<std::vector<double>> referenceTimes(const MidiGridModel& model, int steps, double s_step)
+    {
+        const auto& deltas = model.getDeltas();
+        const auto& events = model.getEvents();
+        int segmentCount = (int)deltas.size();
+        int numBuckets = events.getNumBuckets();
+
+        std::vector<std::vector<double>> expected((size_t)model.getNumTracks());
+        auto place = [&](int bucket, double baseTime, double scale) {
+            for (int i = events.bucketBegin(bucket); i < events.bucketEnd(bucket); ++i)
+                if (events.createMessage(i, 0.0).isNoteOnOrOff())
+                    expected[(size_t)events.getTrackIndex(i)].push_back(baseTime + events.getGrooveOffset(i) * scale);
+            };
+
+        if (numBuckets > 0) place(0, 0.0, 1.0);
+
+        double currentTime = 0.0;
+        for (int k = 0; k < steps; ++k) {
+            double scale = std::pow(s_step, k);
+            int segment = k % segmentCount;
+            currentTime += deltas[(size_t)segment] * scale;
+
+            int nextBucket = segment + 1;
+            if (nextBucket == segmentCount) {
+                if (segmentCount < numBuckets) place(segmentCount, currentTime, scale);
+                if (k < steps - 1) place(0, currentTime, scale);
+            }
+            else if (nextBucket < numBuckets) {
+                place(nextBucket, currentTime, scale);
+            }
+        }
+
+        for (auto& track : expected) std::sort(track.begin(), track.end());
+        return expected;
+    }
+}
+
+// generateOutput + saveFile against the std::pow arithmetic, through every path an output can
+// take: built from scratch, retimed for a new s, continued for a larger N, and built on
+// several threads. Track by track, the sorted reference times must round to the written
+// ticks: each is at most half a tick (plus a little accumulated rounding) from its tick.
+class GenerateOutputTest : public juce::UnitTest
+{
+public:
+    GenerateOutputTest() : juce::UnitTest("Generate output", "CycleSnap") {}
+
+    void runTest() override
+    {
+        const int segments = 64, tracks = 4;
+
+        juce::TemporaryFile source(".mid"), output(".mid");
+        expect(writeSource(source.getFile(), segments, tracks), "Cannot write the source");
+
+        expect(model.load(source.getFile()).wasOk());
+        expect(engine.loadSource(source.getFile()).wasOk());
+
+        const double growing = 1.0005, decaying = 1.0 / 1.0005;
+
+        beginTest("From scratch");
+        engine.setGenerationThreads(1);
+        check(output.getFile(), segments * 8, growing);
+        engine.discardOutput();
+        check(output.getFile(), segments * 8, decaying);
+
+        beginTest("Retimed for a new s");
+        check(output.getFile(), segments * 8, growing);
+        check(output.getFile(), segments * 8, growing * 1.01);
+
+        beginTest("Continued for a larger N");
+        check(output.getFile(), segments * 8 + 5, growing * 1.01);
+        check(output.getFile(), segments * 40, growing * 1.01);
+
+        beginTest("Several threads");
+        engine.setGenerationThreads(tracks);
+        engine.discardOutput();
+        int steps = segments * 160; // Above kParallelGenerationEvents
+        expectGreaterThan(engine.predictOutputEventCount(steps), MidiTransformEngine::kParallelGenerationEvents);
+        check(output.getFile(), steps, decaying);
+    }
+
+private:
+    void check(const juce::File& file, int steps, double s_step)
+    {
+        expect(engine.generateOutput(steps, s_step).wasOk());
+        expect(engine.saveFile(file).wasOk());
+
+        juce::MidiFile written;
+        {
+            juce::FileInputStream stream(file);
+            expect(stream.openedOk() && written.readFrom(stream), "Cannot read the output back");
+        }
+
+        auto expected = referenceTimes(model, steps, s_step);
+        expectEquals(written.getNumTracks(), (int)expected.size());
+
+        for (int t = 0; t < juce::jmin(written.getNumTracks(), (int)expected.size()); ++t) {
+            std::vector<double> ticks;
+            for (auto* holder : *written.getTrack(t))
+                if (holder->message.isNoteOnOrOff()) ticks.push_back(holder->message.getTimeStamp());
+
+            const auto& reference = expected[(size_t)t];
+            expectEquals((int)ticks.size(), (int)reference.size());
+            if (ticks.size() != reference.size()) continue;
+
+            double maxDeviation = 0.0;
+            for (size_t i = 0; i < ticks.size(); ++i)
+                maxDeviation = juce::jmax(maxDeviation, std::abs(reference[i] - ticks[i]));
+
+            expect(maxDeviation <= 0.5 + 1e-3, "Track " + juce::String(t) + ": tick off by "
+                + juce::String(maxDeviation) + " at N = " + juce::String(steps) + ", s = " + juce::String(s_step));
+        }
+    }
+
+    MidiGridModel model;
+    MidiTransformEngine engine;
+};
+
+static GenerateOutputTest generateOutputTest;
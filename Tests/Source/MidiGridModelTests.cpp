@@ -0,0 +1,100 @@
+/*
+  ==============================================================================
+    MidiGridModelTests.cpp
+  ==============================================================================
+*/
+#include <JuceHeader.h>
+#include "MidiTransformEngine.h"
+
+namespace
+{
+    void collectSysex(const juce::MidiMessageSequence& sequence, std::vector<juce::MidiMessage>& found)
+    {
+        for (auto* holder : sequence)
+            if (holder->message.isSysEx()) found.push_back(holder->message);
+    }
+}
+
+// Sysex short enough to pack (F0 F7, F0 7E F7) next to one that goes to the pool, through
+// the event table and out again through generate / save
+class ShortSysexTest : public juce::UnitTest
+{
+public:
+    ShortSysexTest() : juce::UnitTest("Short sysex", "CycleSnap") {}
+
+    void runTest() override
+    {
+        const juce::uint8 body[] = { 0x7e, 0x7f, 0x09, 0x01 };
+        const std::vector<juce::MidiMessage> sysex{
+            juce::MidiMessage::createSysExMessage(body, 0),
+            juce::MidiMessage::createSysExMessage(body, 1),
+            juce::MidiMessage::createSysExMessage(body, 4)
+        };
+
+        // One sysex and one note per grid line
+        juce::MidiMessageSequence track;
+        for (int i = 0; i < (int)sysex.size(); ++i) {
+            track.addEvent(sysex[(size_t)i], i * 480.0);
+            track.addEvent(juce::MidiMessage::noteOn(1, 60 + i, (juce::uint8)100), i * 480.0);
+            track.addEvent(juce::MidiMessage::noteOff(1, 60 + i), (i + 1) * 480.0);
+        }
+        track.updateMatchedPairs();
+
+        juce::MidiFile midi;
+        midi.setTicksPerQuarterNote(960);
+        midi.addTrack(track);
+
+        juce::TemporaryFile source(".mid"), output(".mid");
+        {
+            juce::FileOutputStream stream(source.getFile());
+            expect(stream.openedOk() && midi.writeTo(stream), "Cannot write the source");
+        }
+
+        beginTest("Event table");
+        {
+            MidiGridModel model;
+            expect(model.load(source.getFile()).wasOk());
+
+            const auto& events = model.getEvents();
+            std::vector<juce::MidiMessage> found;
+            for (int i = 0; i < events.getNumEvents(); ++i) {
+                auto m = events.createMessage(i, 0.0);
+                if (!m.isSysEx()) continue;
+
+                expect(!events.isMetaEvent(i));
+                found.push_back(m);
+            }
+            expectSameMessages(found, sysex);
+        }
+
+        beginTest("Generate and save");
+        {
+            MidiTransformEngine engine;
+            expect(engine.loadSource(source.getFile()).wasOk());
+            expect(engine.generateOutput(engine.getSegmentCount(), 1.0).wasOk());
+            expect(engine.saveFile(output.getFile()).wasOk());
+
+            juce::MidiFile written;
+            juce::FileInputStream stream(output.getFile());
+            expect(stream.openedOk() && written.readFrom(stream));
+
+            std::vector<juce::MidiMessage> found;
+            for (int t = 0; t < written.getNumTracks(); ++t)
+                collectSysex(*written.getTrack(t), found);
+            expectSameMessages(found, sysex);
+        }
+    }
+
+private:
+    void expectSameMessages(const std::vector<juce::MidiMessage>& found, const std::vector<juce::MidiMessage>& expected)
+    {
+        expectEquals((int)found.size(), (int)expected.size());
+        for (size_t i = 0; i < juce::jmin(found.size(), expected.size()); ++i) {
+            expect(found[i].getRawDataSize() == expected[i].getRawDataSize()
+                && std::memcmp(found[i].getRawData(), expected[i].getRawData(), (size_t)expected[i].getRawDataSize()) == 0,
+                "Sysex " + juce::String((int)i) + " changed");
+        }
+    }
+};
+
+static ShortSysexTest shortSysexTest;
@@ -0,0 +1,78 @@
+/*
+  ==============================================================================
+    TempoMapTests.cpp
+  ==============================================================================
+*/
+#include <JuceHeader.h>
+#include "TempoMap.h"
+
+// Lookups on random maps of up to 3000 changes (DAW ramp exports), with repeated tempi,
+// changes replacing each other at one tick and invalid tempi, against a linear scan of the
+// changes as they were added
+class TempoMapTest : public juce::UnitTest
+{
+public:
+    TempoMapTest() : juce::UnitTest("Tempo map", "CycleSnap") {}
+
+    void runTest() override
+    {
+        beginTest("Default tempo");
+        {
+            TempoMap map(480, 120.0);
+            expectEquals(map.getMicrosecondsPerQuarterAt(1e9), 500000.0);
+            expectEquals(map.getMsPerTickAt(-10.0), 500000.0 / (1000.0 * 480));
+        }
+
+        beginTest("Random maps against a linear scan");
+        juce::Random random(0x7e3a);
+
+        for (int run = 0; run < 40; ++run) {
+            struct Change { double tick, microsecondsPerQuarter; };
+            std::vector<Change> changes;
+
+            int ppq = 96 * (1 + random.nextInt(10));
+            TempoMap map(ppq, 120.0);
+
+            double tick = 0.0;
+            int numChanges = 1 + random.nextInt(3000);
+            for (int i = 0; i < numChanges; ++i) {
+                if (random.nextInt(4) != 0) tick += 1 + random.nextInt(2000); // Else same tick as before
+
+                double mpq = 300000.0 + 1000.0 * random.nextInt(400);
+                if (!changes.empty() && random.nextInt(5) == 0) mpq = changes.back().microsecondsPerQuarter;
+                if (random.nextInt(50) == 0) mpq = 0.0;
+
+                map.addChange(tick, mpq);
+                changes.push_back({ tick, mpq });
+            }
+
+            auto reference = [&](double t) {
+                double mpq = 500000.0;
+                for (const auto& c : changes)
+                    if (c.tick <= t && c.microsecondsPerQuarter > 0.0) mpq = c.microsecondsPerQuarter;
+                return mpq;
+            };
+
+            bool matches = true;
+            for (int q = 0; q < 200 && matches; ++q) {
+                const auto& c = changes[(size_t)random.nextInt((int)changes.size())];
+                for (double t : { juce::jmax(0.0, c.tick - 0.5), c.tick, c.tick + 0.5, random.nextDouble() * (tick + 1000.0) }) {
+                    double mpq = reference(t);
+                    matches = matches && map.getMicrosecondsPerQuarterAt(t) == mpq
+                                      && map.getMsPerTickAt(t) == mpq / (1000.0 * ppq);
+                }
+            }
+            expect(matches, "Lookup differs from the linear scan in run " + juce::String(run));
+
+            // Folding leaves no segment repeating the tempo before it
+            const auto& segments = map.getSegments();
+            bool folded = true;
+            for (size_t i = 1; i < segments.size(); ++i)
+                folded = folded && segments[i].microsecondsPerQuarter != segments[i - 1].microsecondsPerQuarter
+                                && segments[i].tick > segments[i - 1].tick;
+            expect(folded, "Repeated tempo kept in run " + juce::String(run));
+        }
+    }
+};
+
+static TempoMapTest tempoMapTest;
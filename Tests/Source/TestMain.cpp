@@ -0,0 +1,26 @@
+/*
+  ==============================================================================
+    TestMain.cpp
+    Test entry point.
+
+    Runs every juce::UnitTest registered in this target (category "CycleSnap"):
+
+      CycleSnapTests
+
+    The exit code is 1 when any expectation failed.
+  ==============================================================================
+*/
+#include <JuceHeader.h>
+
+int main()
+{
+    juce::UnitTestRunner runner;
+    runner.setAssertOnFailure(false);
+    runner.runTestsInCategory("CycleSnap");
+
+    int failures = 0;
+    for (int i = 0; i < runner.getNumResults(); ++i)
+        failures += runner.getResult(i)->failures;
+
+    return failures == 0 ? 0 : 1;
+}